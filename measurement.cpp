@@ -1,8 +1,11 @@
 #include <iostream>
 #include <chrono>
 #include <fstream>
+#include <vector>
+#include <random>
 #include "src/board.h"
 #include "src/ai.h"
+#include "src/eval.h"
 
 using namespace std;
 using namespace std::chrono;
@@ -18,12 +21,13 @@ double measure_time(Function func) {
 }
 
 // Klasyczny minimax bez przycinania alfa-beta
-int minimax_no_pruning(Board board, int depth, bool maximizingPlayer) {
+int minimax_no_pruning(Board& board, int depth, bool maximizingPlayer) {
     if (depth == 0) {
         return board.evaluate();
     }
     
-    auto moves = board.getValidMoves(maximizingPlayer);
+    MoveList moves;
+    board.generateMoves(maximizingPlayer, moves);
     if (moves.empty()) {
         return maximizingPlayer ? numeric_limits<int>::min() + 1 
                                 : numeric_limits<int>::max() - 1;
@@ -32,24 +36,274 @@ int minimax_no_pruning(Board board, int depth, bool maximizingPlayer) {
     if (maximizingPlayer) {
         int maxEval = numeric_limits<int>::min();
         for (const auto& move : moves) {
-            Board newBoard = board;
-            newBoard.applyMove(move);
-            int eval = minimax_no_pruning(newBoard, depth - 1, false);
+            MoveUndo undo;
+            board.applyMove(move, undo);
+            int eval = minimax_no_pruning(board, depth - 1, false);
+            board.undoMove(move, undo);
             maxEval = max(maxEval, eval);
         }
         return maxEval;
     } else {
         int minEval = numeric_limits<int>::max();
         for (const auto& move : moves) {
-            Board newBoard = board;
-            newBoard.applyMove(move);
-            int eval = minimax_no_pruning(newBoard, depth - 1, true);
+            MoveUndo undo;
+            board.applyMove(move, undo);
+            int eval = minimax_no_pruning(board, depth - 1, true);
+            board.undoMove(move, undo);
             minEval = min(minEval, eval);
         }
         return minEval;
     }
 }
 
+// Zestaw pozycji testowych: początek gry i pozycje po kilku deterministycznie wybranych ruchach
+vector<Board> benchmark_positions() {
+    const int PLIES[] = {0, 6, 12, 18};
+    vector<Board> positions;
+
+    for (int plies : PLIES) {
+        Board board;
+        bool aiTurn = false; // gracz zaczyna
+        for (int ply = 0; ply < plies; ply++) {
+            MoveList moves;
+            board.generateMoves(aiTurn, moves);
+            if (moves.empty()) break;
+            board.applyMove(moves[(ply * 7) % moves.size()]);
+            aiTurn = !aiTurn;
+        }
+        if (!aiTurn) {
+            // Pozycje mierzymy zawsze z ruchem AI
+            MoveList moves;
+            board.generateMoves(false, moves);
+            if (moves.empty()) continue;
+            board.applyMove(moves[0]);
+        }
+        positions.push_back(board);
+    }
+    return positions;
+}
+
+// Porównanie alfa-beta i PVS (z oknami aspiracyjnymi) w pogłębianiu iteracyjnym
+void measure_algorithms(ostream& out, ostream& file) {
+    const int DEPTHS[] = {4, 8, 10};
+    const SearchAlgorithm ALGORITHMS[] = {SearchAlgorithm::ALPHA_BETA, SearchAlgorithm::PVS};
+    vector<Board> positions = benchmark_positions();
+
+    for (ostream* stream : {&out, &file}) {
+        *stream << "\n=== Alfa-beta a PVS (" << positions.size() << " pozycji) ===\n";
+    }
+
+    for (int depth : DEPTHS) {
+        for (SearchAlgorithm algorithm : ALGORITHMS) {
+            AI ai;
+            ai.setAlgorithm(algorithm);
+
+            SearchLimits limits;
+            limits.maxDepth = depth;
+
+            double totalTime = 0.0;
+            uint64_t totalNodes = 0;
+            for (const Board& position : positions) {
+                ai.newGame();
+                totalTime += measure_time([&]() { ai.search(position, limits); });
+                totalNodes += ai.getStats().nodes;
+            }
+
+            const char* name = algorithm == SearchAlgorithm::PVS ? "PVS" : "alfa-beta";
+            for (ostream* stream : {&out, &file}) {
+                *stream << "   Głębokość " << depth << ", " << name << ": " << totalTime << " s, "
+                        << totalNodes << " węzłów\n";
+            }
+        }
+    }
+}
+
+// Przycinanie selektywne (PVS): węzły i czas z LMR i futility, osobno i razem
+void measure_pruning(ostream& out, ostream& file) {
+    const int DEPTH = static_cast<int>(Difficulty::HARD);
+    vector<Board> positions = benchmark_positions();
+
+    for (ostream* stream : {&out, &file}) {
+        *stream << "\n=== Przycinanie selektywne (PVS, głębokość " << DEPTH << ", "
+                << positions.size() << " pozycji) ===\n";
+    }
+
+    for (int variant = 0; variant < 4; variant++) {
+        bool reductions = variant & 1;
+        bool futility = variant & 2;
+
+        AI ai;
+        ai.setAlgorithm(SearchAlgorithm::PVS);
+        ai.setLateMoveReductions(reductions);
+        ai.setFutilityPruning(futility);
+
+        double totalTime = 0.0;
+        SearchStats total;
+        for (const Board& position : positions) {
+            ai.newGame();
+            totalTime += measure_time([&]() { ai.getBestMove(position, DEPTH); });
+            total.nodes += ai.getStats().nodes;
+            total.reductions += ai.getStats().reductions;
+            total.reSearches += ai.getStats().reSearches;
+            total.futilityPrunes += ai.getStats().futilityPrunes;
+        }
+
+        for (ostream* stream : {&out, &file}) {
+            *stream << "   LMR " << (reductions ? "tak" : "nie") << ", futility " << (futility ? "tak" : "nie")
+                    << ": " << totalTime << " s, " << total.nodes << " węzłów, "
+                    << total.reductions << " redukcji (" << total.reSearches << " powtórzonych), "
+                    << total.futilityPrunes << " pominiętych ruchów\n";
+        }
+    }
+}
+
+// Losowa pozycja: każde ciemne pole puste albo z pionkiem/damką jednej ze stron
+Board random_position(mt19937& rng) {
+    Board board;
+    uniform_int_distribution<int> content(0, 9);
+    for (int row = 0; row < Board::SIZE; row++) {
+        for (int col = 0; col < Board::SIZE; col++) {
+            if ((row + col) % 2 == 0) continue;
+            int c = content(rng);
+            shared_ptr<Piece> piece;
+            if (c < 4) piece = make_shared<Piece>(c % 2 == 1, c >= 2);
+            board.setPiece(row, col, piece);
+        }
+    }
+    return board;
+}
+
+// Jądro oceny na maskach: porównanie z Board::evaluate na losowych pozycjach
+// oraz przepustowość poszczególnych wersji
+bool measure_eval_kernels(ostream& out, ostream& file) {
+    const int POSITIONS = 100000;
+    const int ROUNDS = 20;
+    const EvalKernel KERNELS[] = {EvalKernel::SCALAR, EvalKernel::SSE, EvalKernel::AVX2};
+    const char* NAMES[] = {"skalarne", "SSE4.1", "AVX2"};
+
+    mt19937 rng(12345);
+    vector<Board> boards;
+    vector<EvalPosition> positions;
+    vector<int> expected;
+    bool ok = true;
+    for (int i = 0; i < POSITIONS; i++) {
+        boards.push_back(random_position(rng));
+        positions.push_back(EvalPosition(boards.back()));
+        expected.push_back(boards.back().evaluate());
+        ok = ok && expected.back() == boards.back().computeEvaluation();
+    }
+
+    for (ostream* stream : {&out, &file}) {
+        *stream << "\n=== Jądro oceny na maskach (" << POSITIONS << " losowych pozycji) ===\n";
+    }
+
+    vector<int> scores(POSITIONS);
+    for (int k = 0; k < 3; k++) {
+        if (!isEvalKernelSupported(KERNELS[k])) {
+            for (ostream* stream : {&out, &file}) {
+                *stream << "   " << NAMES[k] << ": nieobsługiwane przez procesor\n";
+            }
+            continue;
+        }
+
+        int mismatches = 0;
+        double time = measure_time([&]() {
+            for (int round = 0; round < ROUNDS; round++) {
+                evaluateBatch(positions.data(), scores.data(), positions.size(), KERNELS[k]);
+            }
+        });
+        for (int i = 0; i < POSITIONS; i++) {
+            if (scores[i] != expected[i]) mismatches++;
+        }
+        ok = ok && mismatches == 0;
+
+        for (ostream* stream : {&out, &file}) {
+            *stream << "   " << NAMES[k] << ": " << static_cast<uint64_t>(POSITIONS * ROUNDS / time)
+                    << " pozycji/s, niezgodności: " << mismatches << "\n";
+        }
+    }
+
+    // Bufor struktury tablic: ten sam zestaw powielony do rozmiaru, przy którym ocena dzieli się na wątki
+    const int COPIES = 10;
+    PositionBuffer buffer;
+    buffer.reserve(POSITIONS * COPIES);
+    for (int copy = 0; copy < COPIES; copy++) {
+        for (const EvalPosition& position : positions) buffer.push(position);
+    }
+
+    vector<int> bufferScores(buffer.size());
+    const int THREAD_COUNTS[] = {1, 0};
+    for (int threads : THREAD_COUNTS) {
+        int mismatches = 0;
+        double time = measure_time([&]() {
+            for (int round = 0; round < ROUNDS / COPIES; round++) {
+                evaluateBuffer(buffer, bufferScores.data(), threads);
+            }
+        });
+        for (size_t i = 0; i < buffer.size(); i++) {
+            if (bufferScores[i] != expected[i % POSITIONS]) mismatches++;
+        }
+        ok = ok && mismatches == 0;
+
+        for (ostream* stream : {&out, &file}) {
+            *stream << "   Bufor SoA, " << (threads ? "1 wątek" : "wszystkie rdzenie") << ": "
+                    << static_cast<uint64_t>(POSITIONS * ROUNDS / time) << " pozycji/s, niezgodności: "
+                    << mismatches << "\n";
+        }
+    }
+
+    // Dawna pętla po pionkach dla porównania
+    double time = measure_time([&]() {
+        for (int round = 0; round < ROUNDS; round++) {
+            for (const Board& board : boards) board.computeEvaluation();
+        }
+    });
+    for (ostream* stream : {&out, &file}) {
+        *stream << "   Pętla po pionkach: " << static_cast<uint64_t>(POSITIONS * ROUNDS / time) << " pozycji/s\n";
+    }
+
+    return ok;
+}
+
+// Skalowanie wątków: czas dojścia do stałej głębokości na zestawie pozycji
+void measure_thread_scaling(ostream& out, ostream& file) {
+    const int THREADS[] = {1, 2, 4, 8};
+    const ParallelMode MODES[] = {ParallelMode::LAZY_SMP, ParallelMode::ROOT_SPLIT};
+    const int DEPTH = 10;
+    vector<Board> positions = benchmark_positions();
+
+    for (ParallelMode mode : MODES) {
+        const char* name = mode == ParallelMode::LAZY_SMP ? "Lazy SMP" : "podział korzenia";
+        double baseTime = 0.0;
+
+        for (ostream* stream : {&out, &file}) {
+            *stream << "\n=== Skalowanie wątków: " << name << " (głębokość " << DEPTH << ", "
+                    << positions.size() << " pozycji) ===\n";
+        }
+
+        for (int threads : THREADS) {
+            AI ai;
+            ai.setThreads(threads);
+            ai.setParallelMode(mode);
+
+            double totalTime = 0.0;
+            uint64_t totalNodes = 0;
+            for (const Board& position : positions) {
+                ai.newGame();
+                totalTime += measure_time([&]() { ai.getBestMove(position, DEPTH); });
+                totalNodes += ai.getStats().nodes;
+            }
+            if (threads == 1) baseTime = totalTime;
+
+            for (ostream* stream : {&out, &file}) {
+                *stream << "   Wątki: " << threads << ": " << totalTime << " s, "
+                        << totalNodes << " węzłów, " << static_cast<uint64_t>(totalNodes / totalTime) << " węzłów/s, "
+                        << "przyspieszenie x" << baseTime / totalTime << "\n";
+            }
+        }
+    }
+}
+
 int main() {
     const Difficulty LEVELS[] = {Difficulty::EASY, Difficulty::MEDIUM, Difficulty::HARD};
     const int TESTS = 50;
@@ -72,23 +326,48 @@ int main() {
 
         double total_time_pruning = 0.0;
         double total_time_no_pruning = 0.0;
+        uint64_t total_nodes_pruning = 0;
+        uint64_t total_qnodes = 0;
+        uint64_t total_cutoffs = 0;
+        uint64_t total_first_move_cutoffs = 0;
 
         int depth = static_cast<int>(level); // Konwersja poziomu na głębokość
 
         for (int t = 0; t < TESTS; t++) {
+            ai.newGame(); // Każdy pomiar zaczyna bez wiedzy z poprzednich (tablica, historia)
             total_time_pruning += measure_time([&]() { ai.getBestMove(board, depth); });
+            total_nodes_pruning += ai.getStats().nodes;
+            total_qnodes += ai.getStats().qnodes;
+            total_cutoffs += ai.getStats().cutoffs;
+            total_first_move_cutoffs += ai.getStats().firstMoveCutoffs;
             total_time_no_pruning += measure_time([&]() { minimax_no_pruning(board, depth, true); });
         }
 
         double avg_time_pruning = total_time_pruning / TESTS;
         double avg_time_no_pruning = total_time_no_pruning / TESTS;
 
-        cout << "🔹 Minimax z przycinaniem: " << avg_time_pruning << " s\n";
+        uint64_t avg_nodes_pruning = total_nodes_pruning / TESTS;
+        uint64_t avg_qnodes = total_qnodes / TESTS;
+        double first_move_cutoff_rate = total_cutoffs ? 100.0 * total_first_move_cutoffs / total_cutoffs : 0.0;
+
+        cout << "🔹 Minimax z przycinaniem: " << avg_time_pruning << " s (" << avg_nodes_pruning << " węzłów, "
+             << avg_qnodes << " w quiescence)\n";
         cout << "🔸 Minimax bez przycinania: " << avg_time_no_pruning << " s\n";
+        cout << "   Odcięcia na pierwszym ruchu: " << first_move_cutoff_rate << " %\n";
 
-        resultsFile << "🔹 Minimax z przycinaniem: " << avg_time_pruning << " s\n";
+        resultsFile << "🔹 Minimax z przycinaniem: " << avg_time_pruning << " s (" << avg_nodes_pruning << " węzłów, "
+                    << avg_qnodes << " w quiescence)\n";
         resultsFile << "🔸 Minimax bez przycinania: " << avg_time_no_pruning << " s\n";
+        resultsFile << "   Odcięcia na pierwszym ruchu: " << first_move_cutoff_rate << " %\n";
+    }
+
+    if (!measure_eval_kernels(cout, resultsFile)) {
+        cerr << "Jądro oceny daje inne wyniki niż Board::evaluate!" << endl;
+        return 1;
     }
+    measure_algorithms(cout, resultsFile);
+    measure_pruning(cout, resultsFile);
+    measure_thread_scaling(cout, resultsFile);
 
     resultsFile.close();
     return 0;
@@ -0,0 +1,247 @@
+#include <iostream>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "src/board.h"
+#include "src/threadpool.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Perft: liczba liści drzewa ruchów do zadanej głębokości, bez oceny i przycinania.
+// Sprawdza i mierzy samo generowanie, wykonywanie i cofanie ruchów.
+//
+// Użycie: perft [-d głębokość] [-t wątki] [-f plik] [--divide]
+//   bez -f       pozycja początkowa, głębokości od 1 do -d (domyślnie 8)
+//   -f plik      pozycje z pliku; liczby różne od wzorcowych kończą program kodem 1
+//   -t wątki     ruchy w korzeniu rozdzielane między wątki (0 = wszystkie rdzenie)
+//   --divide     liczby liści osobno dla każdego ruchu w korzeniu
+//
+// Plik pozycji: jedna pozycja w wierszu, '#' rozpoczyna komentarz
+//   <plansza> <strona> <głębokość>:<liczba> ...
+// plansza to "start" albo 64 znaki wierszami od wiersza 0: '.' puste pole,
+// 'a'/'A' pionek/damka AI, 'p'/'P' pionek/damka gracza; strona na ruchu: ai albo player
+
+struct PerftPosition {
+    string name;
+    Board board;
+    vector<pair<int, uint64_t>> expected; // (głębokość, liczba liści)
+};
+
+uint64_t perft(Board& board, int depth) {
+    if (depth == 0) return 1;
+
+    MoveList moves;
+    board.generateMoves(board.isAIToMove(), moves);
+    if (depth == 1) return moves.size(); // liście bez wykonywania ruchów
+
+    uint64_t nodes = 0;
+    for (const auto& move : moves) {
+        MoveUndo undo;
+        board.applyMove(move, undo);
+        nodes += perft(board, depth - 1);
+        board.undoMove(move, undo);
+    }
+    return nodes;
+}
+
+string moveText(const Move& move) {
+    ostringstream text;
+    text << int(move.srcRow) << int(move.srcCol) << (move.isCapture() ? 'x' : '-')
+         << int(move.dstRow) << int(move.dstCol);
+    return text.str();
+}
+
+// Liczby liści dla poszczególnych ruchów w korzeniu; przy więcej niż jednym
+// wątku każdy ruch jest zadaniem puli z własną kopią planszy
+vector<uint64_t> perftDivide(const Board& board, int depth, const MoveList& moves, ThreadPool* pool) {
+    vector<uint64_t> counts(moves.size());
+
+    if (!pool) {
+        Board copy = board;
+        for (int i = 0; i < moves.size(); i++) {
+            MoveUndo undo;
+            copy.applyMove(moves[i], undo);
+            counts[i] = perft(copy, depth - 1);
+            copy.undoMove(moves[i], undo);
+        }
+        return counts;
+    }
+
+    vector<ThreadPool::Task> tasks;
+    for (int i = 0; i < moves.size(); i++) {
+        tasks.push_back([&board, &moves, &counts, depth, i](int) {
+            Board copy = board;
+            copy.applyMove(moves[i]);
+            counts[i] = perft(copy, depth - 1);
+        });
+    }
+    pool->run(tasks);
+    return counts;
+}
+
+// Wynik jednej głębokości; false, gdy różni się od wzorcowego (expected > 0)
+bool runDepth(const Board& board, int depth, uint64_t expected, bool divide, ThreadPool* pool) {
+    MoveList moves;
+    board.generateMoves(board.isAIToMove(), moves);
+
+    auto start = steady_clock::now();
+    uint64_t nodes = 0;
+    vector<uint64_t> counts;
+    if (depth == 0) {
+        nodes = 1;
+    } else {
+        counts = perftDivide(board, depth, moves, pool);
+        for (uint64_t count : counts) nodes += count;
+    }
+    double seconds = duration<double>(steady_clock::now() - start).count();
+
+    if (divide) {
+        for (int i = 0; i < static_cast<int>(counts.size()); i++) {
+            cout << "      " << moveText(moves[i]) << ": " << counts[i] << "\n";
+        }
+    }
+
+    bool ok = expected == 0 || nodes == expected;
+    cout << "   Głębokość " << depth << ": " << nodes << " liści, " << seconds << " s, "
+         << static_cast<uint64_t>(seconds > 0 ? nodes / seconds : 0) << " liści/s";
+    if (expected) {
+        cout << (ok ? " (zgodne)" : " (BŁĄD, oczekiwano " + to_string(expected) + ")");
+    }
+    cout << endl;
+    return ok;
+}
+
+bool parseBoard(const string& text, Board& board) {
+    if (text == "start") {
+        board.init();
+        return true;
+    }
+    if (text.size() != 64) return false;
+
+    for (int row = 0; row < Board::SIZE; row++) {
+        for (int col = 0; col < Board::SIZE; col++) {
+            char c = text[row * Board::SIZE + col];
+            shared_ptr<Piece> piece;
+            if (c == 'a' || c == 'A' || c == 'p' || c == 'P') {
+                if (!isDarkSquare(row, col)) return false;
+                piece = make_shared<Piece>(c == 'a' || c == 'A', c == 'A' || c == 'P');
+            } else if (c != '.') {
+                return false;
+            }
+            board.setPiece(row, col, piece);
+        }
+    }
+    return true;
+}
+
+bool loadPositions(const string& path, vector<PerftPosition>& positions) {
+    ifstream file(path);
+    if (!file.is_open()) {
+        cerr << "Nie udało się otworzyć pliku " << path << endl;
+        return false;
+    }
+
+    string line;
+    int lineNumber = 0;
+    while (getline(file, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+
+        istringstream fields(line);
+        string boardText, sideText;
+        if (!(fields >> boardText)) continue; // pusty wiersz lub komentarz
+
+        PerftPosition position;
+        position.name = path + ":" + to_string(lineNumber);
+        bool ok = fields >> sideText && (sideText == "ai" || sideText == "player") &&
+                  parseBoard(boardText, position.board);
+
+        string entry;
+        while (ok && fields >> entry) {
+            size_t colon = entry.find(':');
+            ok = colon != string::npos;
+            if (ok) {
+                position.expected.push_back(make_pair(atoi(entry.substr(0, colon).c_str()),
+                                                      strtoull(entry.substr(colon + 1).c_str(), nullptr, 10)));
+            }
+        }
+        if (!ok) {
+            cerr << "Niepoprawny wiersz " << position.name << endl;
+            return false;
+        }
+
+        position.board.setAIToMove(sideText == "ai");
+        positions.push_back(position);
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    int maxDepth = 0;
+    int threads = 1;
+    bool divide = false;
+    string path;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-d" && i + 1 < argc) {
+            maxDepth = atoi(argv[++i]);
+        } else if (arg == "-t" && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (arg == "-f" && i + 1 < argc) {
+            path = argv[++i];
+        } else if (arg == "--divide") {
+            divide = true;
+        } else {
+            cerr << "Użycie: perft [-d głębokość] [-t wątki] [-f plik] [--divide]" << endl;
+            return 1;
+        }
+    }
+
+    if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+    unique_ptr<ThreadPool> pool;
+    if (threads > 1) pool.reset(new ThreadPool(threads));
+
+    if (path.empty()) {
+        if (maxDepth <= 0) maxDepth = 8;
+        Board board;
+        cout << "=== Perft z pozycji początkowej (wątki: " << threads << ") ===\n";
+        for (int depth = 1; depth <= maxDepth; depth++) {
+            runDepth(board, depth, 0, divide && depth == maxDepth, pool.get());
+        }
+        return 0;
+    }
+
+    vector<PerftPosition> positions;
+    if (!loadPositions(path, positions)) return 1;
+
+    // Bez -d sprawdzane są wszystkie zapisane głębokości, z -d tylko te nie większe
+    int failures = 0;
+    for (auto& position : positions) {
+        cout << "=== " << position.name << " (na ruchu: "
+             << (position.board.isAIToMove() ? "AI" : "gracz") << ") ===\n";
+        for (size_t i = 0; i < position.expected.size(); i++) {
+            int depth = position.expected[i].first;
+            if (maxDepth > 0 && depth > maxDepth) continue;
+            bool last = i + 1 == position.expected.size() ||
+                        (maxDepth > 0 && position.expected[i + 1].first > maxDepth);
+            if (!runDepth(position.board, depth, position.expected[i].second, divide && last, pool.get())) {
+                failures++;
+            }
+        }
+    }
+
+    if (failures) {
+        cerr << failures << " wyników różni się od wzorcowych!" << endl;
+        return 1;
+    }
+    cout << "Wszystkie wyniki zgodne z wzorcowymi." << endl;
+    return 0;
+}
@@ -1,84 +1,739 @@
 #include "ai.h"
 #include <limits>
 #include <algorithm>
+#include <functional>
 
-Move AI::getBestMove(Board board, int depth) {
-    Move bestMove;
-    int bestValue = std::numeric_limits<int>::min();
-    auto moves = board.getValidMoves(true);
+AI::AI() : threads(1) {}
+
+void AI::setThreads(int count) {
+    threads.resize(std::max(1, count));
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].id = static_cast<int>(i);
+    }
+    pool.reset();
+}
+
+void AI::newGame() {
+    table.clear();
+    for (auto& thread : threads) {
+        thread.ordering.clear();
+    }
+    principalVariation.clear();
+}
+
+bool AI::rootSplitActive() const {
+    return parallelMode == ParallelMode::ROOT_SPLIT && threads.size() > 1;
+}
+
+Move AI::getBestMove(const Board& board, int depth) {
+    MoveList moves;
+    board.generateMoves(true, moves);
 
     if (moves.empty()) {
-        return bestMove; // Brak możliwych ruchów
+        return Move(); // Brak możliwych ruchów
+    }
+
+    SearchLimits fixedDepth;
+    fixedDepth.maxDepth = depth;
+    startSearch(board, fixedDepth);
+
+    std::vector<std::thread> helpers;
+    startHelpers(helpers, moves);
+
+    int bestValue;
+    Move bestMove = rootSplitActive() ? searchRootSplit(depth, moves, bestValue)
+                                      : searchRoot(threads[0], depth, moves, std::numeric_limits<int>::min(),
+                                                   std::numeric_limits<int>::max(), bestValue);
+    threads[0].stats.depth = depth;
+
+    stopHelpers(helpers);
+    savePrincipalVariation();
+    return bestMove;
+}
+
+Move AI::search(const Board& board, const SearchLimits& searchLimits) {
+    MoveList moves;
+    board.generateMoves(true, moves);
+
+    if (moves.empty()) {
+        return Move(); // Brak możliwych ruchów
+    }
+
+    startSearch(board, searchLimits);
+
+    std::vector<std::thread> helpers;
+    startHelpers(helpers, moves);
+
+    // Gdy żadna iteracja się nie zakończy, zwracamy pierwszy legalny ruch
+    Move bestMove = moves[0];
+    int bestValue = 0;
+
+    for (int depth = 1; depth <= limits.maxDepth; depth++) {
+        int value;
+        Move iterationBest;
+        if (rootSplitActive()) {
+            iterationBest = searchRootSplit(depth, moves, value);
+        } else if (algorithm == SearchAlgorithm::PVS && depth > 1) {
+            iterationBest = searchAspiration(depth, moves, bestValue, value);
+        } else {
+            iterationBest = searchRoot(threads[0], depth, moves, std::numeric_limits<int>::min(),
+                                       std::numeric_limits<int>::max(), value);
+        }
+        if (stopped) {
+            break; // Przerwana iteracja - zostaje wynik poprzedniej
+        }
+
+        bestMove = iterationBest;
+        bestValue = value;
+        threads[0].stats.depth = depth;
+
+        // Najlepszy ruch z tej iteracji sprawdzamy jako pierwszy w następnej;
+        // porównujemy także zbite pionki, bo ścieżki bicia mogą mieć te same końce
+        for (auto it = moves.begin(); it != moves.end(); ++it) {
+            if (TranspositionTable::sameMove(*it, TranspositionTable::packMove(bestMove)) &&
+                it->capturedMask == bestMove.capturedMask) {
+                std::rotate(moves.begin(), it, it + 1);
+                break;
+            }
+        }
+
+        // Kolejna iteracja trwa zwykle dłużej niż wszystkie poprzednie razem
+        if (limits.timeMs > 0) {
+            auto elapsed = std::chrono::steady_clock::now() - startTime;
+            if (std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() * 2 >= limits.timeMs) {
+                break;
+            }
+        }
+    }
+
+    stopHelpers(helpers);
+    savePrincipalVariation();
+    return bestMove;
+}
+
+void AI::savePrincipalVariation() {
+    // Wariant odczytany z tablicy: z każdej pozycji zapisany najlepszy ruch, o ile jest legalny
+    principalVariation.clear();
+    Board board = threads[0].board;
+    int length = std::max(1, threads[0].stats.depth);
+
+    for (int ply = 0; ply < length; ply++) {
+        TTData entry;
+        if (!table.probe(board.getHash(), entry) || !entry.move) break;
+
+        MoveList moves;
+        board.generateMoves(board.isAIToMove(), moves);
+        auto it = std::find_if(moves.begin(), moves.end(), [&entry](const Move& move) {
+            return TranspositionTable::sameMove(move, entry.move);
+        });
+        if (it == moves.end()) break;
+
+        principalVariation.push_back(std::make_pair(board.getHash(), entry.move));
+        board.applyMove(*it);
+    }
+}
+
+void AI::seedPrincipalVariation(const Board& root) {
+    // Zwykle korzeń to pozycja dwa ruchy dalej w poprzednim wariancie. Jego reszta
+    // wraca do tablicy tam, gdzie wpisy zostały wyparte - tylko jako ruch do sprawdzenia
+    // w pierwszej kolejności, bez wyniku.
+    auto start = std::find_if(principalVariation.begin(), principalVariation.end(),
+                              [&root](const std::pair<uint64_t, uint16_t>& step) {
+                                  return step.first == root.getHash();
+                              });
+    for (auto it = start; it != principalVariation.end(); ++it) {
+        TTData entry;
+        if (!table.probe(it->first, entry) || !entry.move) {
+            table.store(it->first, 0, 0, Bound::NONE, it->second);
+        }
+    }
+}
+
+bool AI::getPonderMove(const Board& board, Move& move) const {
+    MoveList moves;
+    board.generateMoves(false, moves);
+    if (moves.empty()) return false;
+
+    // Odpowiedź z głównego wariantu, a gdy pozycji w nim nie ma - z tablicy
+    uint16_t predicted = 0;
+    for (const auto& step : principalVariation) {
+        if (step.first == board.getHash()) predicted = step.second;
+    }
+    TTData entry;
+    if (!predicted && table.probe(board.getHash(), entry)) {
+        predicted = entry.move;
+    }
+
+    if (predicted) {
+        for (const auto& candidate : moves) {
+            if (TranspositionTable::sameMove(candidate, predicted)) {
+                move = candidate;
+                return true;
+            }
+        }
+    }
+
+    if (moves.size() == 1) {
+        move = moves[0];
+        return true;
+    }
+    return false;
+}
+
+void AI::startSearch(const Board& board, const SearchLimits& searchLimits) {
+    limits = searchLimits;
+    startTime = std::chrono::steady_clock::now();
+    stopped = false;
+    sharedNodes = 0;
+    stats = SearchStats();
+    table.newSearch();
+
+    // Odcięcia z tablicy zależą od kolejności zapisów między wątkami
+    useHashScores = !(rootSplitActive() && deterministic);
+    // Redukcje zależą od kolejności ruchów, a ta od historii wątku
+    useReductions = lateMoveReductions && !(rootSplitActive() && deterministic);
+    // Futility porównuje ocenę z alfą, a ta przy podziale korzenia zależy od tego,
+    // który wątek pierwszy poprawi wspólny wynik
+    useFutility = futilityPruning && !(rootSplitActive() && deterministic);
+    if (rootSplitActive() && !pool) {
+        pool.reset(new ThreadPool(getThreads()));
+    }
+
+    // Każdy wątek dostaje własną kopię planszy; tablice kolejności zostają po
+    // poprzednim ruchu partii z osłabioną historią
+    for (auto& thread : threads) {
+        thread.board = board;
+        thread.board.setAIToMove(true);
+        thread.ordering.age();
+        thread.stats = SearchStats();
     }
+    seedPrincipalVariation(threads[0].board);
+}
+
+bool AI::checkLimits(SearchThread& thread) {
+    // Budżet węzłów, zegar i flagę przerwania sprawdzamy co 1024 węzły każdego wątku,
+    // licząc także węzły quiescence - długa seria bić też musi dać się przerwać
+    if (((thread.stats.nodes + thread.stats.qnodes) & 1023) == 0) {
+        if (limits.stop && limits.stop->load(std::memory_order_relaxed)) {
+            stopped = true;
+        }
+
+        uint64_t nodes = sharedNodes.fetch_add(1024, std::memory_order_relaxed) + 1024;
+        if (limits.nodes > 0 && nodes >= limits.nodes) {
+            stopped = true;
+        }
+
+        if (limits.timeMs > 0) {
+            auto elapsed = std::chrono::steady_clock::now() - startTime;
+            if (std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() >= limits.timeMs) {
+                stopped = true;
+            }
+        }
+    }
+
+    return stopped.load(std::memory_order_relaxed);
+}
+
+void AI::startHelpers(std::vector<std::thread>& helpers, const MoveList& rootMoves) {
+    if (rootSplitActive()) return; // wątki pracują w puli
+
+    for (size_t i = 1; i < threads.size(); i++) {
+        helpers.emplace_back(&AI::helperSearch, this, std::ref(threads[i]), rootMoves);
+    }
+}
+
+void AI::stopHelpers(std::vector<std::thread>& helpers) {
+    stopped = true;
+    for (auto& helper : helpers) {
+        helper.join();
+    }
+    collectStats();
+}
+
+void AI::collectStats() {
+    stats = threads[0].stats;
+    for (size_t i = 1; i < threads.size(); i++) {
+        const SearchStats& helperStats = threads[i].stats;
+        stats.nodes += helperStats.nodes;
+        stats.ttHits += helperStats.ttHits;
+        stats.ttCutoffs += helperStats.ttCutoffs;
+        stats.cutoffs += helperStats.cutoffs;
+        stats.firstMoveCutoffs += helperStats.firstMoveCutoffs;
+        stats.qnodes += helperStats.qnodes;
+        stats.reductions += helperStats.reductions;
+        stats.reSearches += helperStats.reSearches;
+        stats.futilityPrunes += helperStats.futilityPrunes;
+    }
+}
+
+void AI::helperSearch(SearchThread& thread, MoveList rootMoves) {
+    // Nieparzyste wątki są o jedną iterację przed głównym, a każdy zaczyna
+    // od innego ruchu w korzeniu, żeby nie powtarzać dokładnie tej samej pracy
+    if (rootMoves.size() > 1) {
+        int first = thread.id % rootMoves.size();
+        std::rotate(rootMoves.begin(), rootMoves.begin() + first, rootMoves.end());
+    }
+
+    for (int depth = 1 + thread.id % 2; depth <= SearchLimits::MAX_DEPTH && !stopped; depth++) {
+        int value;
+        searchRoot(thread, depth, rootMoves, std::numeric_limits<int>::min(),
+                   std::numeric_limits<int>::max(), value);
+    }
+}
+
+Move AI::searchRoot(SearchThread& thread, int depth, MoveList& moves, int alpha, int beta, int& bestValue) {
+    Board& board = thread.board;
+    Move bestMove;
+    bestValue = std::numeric_limits<int>::min();
+    int alphaOrig = alpha;
+    bool pvs = algorithm == SearchAlgorithm::PVS;
 
     for (const auto& move : moves) {
-        Board newBoard = board;
-        newBoard.applyMove(move);
-        
-        int moveValue = minimax(newBoard, depth - 1, 
-                               std::numeric_limits<int>::min(),
-                               std::numeric_limits<int>::max(), false);
+        MoveUndo undo;
+        board.applyMove(move, undo);
+
+        int moveValue;
+        if (!pvs) {
+            // Alfa-beta: każdy ruch w korzeniu z tym samym oknem
+            moveValue = minimax(thread, depth - 1, 1, alphaOrig, beta, false);
+        } else if (&move == moves.begin()) {
+            moveValue = minimax(thread, depth - 1, 1, alpha, beta, false);
+        } else {
+            // Zerowe okno sprawdza tylko, czy ruch jest lepszy od dotychczasowego
+            moveValue = minimax(thread, depth - 1, 1, alpha, alpha + 1, false);
+            if (moveValue > alpha && moveValue < beta) {
+                moveValue = minimax(thread, depth - 1, 1, alpha, beta, false);
+            }
+        }
+        board.undoMove(move, undo);
+        if (stopped) {
+            return bestMove;
+        }
         
         if (moveValue > bestValue) {
             bestValue = moveValue;
             bestMove = move;
         }
+
+        if (pvs) {
+            alpha = std::max(alpha, moveValue);
+            if (alpha >= beta) {
+                break; // Wynik powyżej okna aspiracyjnego
+            }
+        }
     }
+
+    // Przy pełnym oknie wynik korzenia jest dokładny
+    Bound bound = Bound::EXACT;
+    if (bestValue <= alphaOrig) {
+        bound = Bound::UPPER;
+    } else if (bestValue >= beta) {
+        bound = Bound::LOWER;
+    }
+    table.store(board.getHash(), depth, bestValue, bound, TranspositionTable::packMove(bestMove));
     
     return bestMove;
 }
 
-int AI::minimax(Board board, int depth, int alpha, int beta, bool maximizingPlayer) {
+Move AI::searchAspiration(int depth, MoveList& moves, int previousValue, int& bestValue) {
+    // Okno liczymy na 64 bitach i przycinamy, żeby wyniki bliskie wygranej nie przepełniły inta
+    const int64_t MIN_SCORE = std::numeric_limits<int>::min();
+    const int64_t MAX_SCORE = std::numeric_limits<int>::max();
+    int64_t delta = ASPIRATION_WINDOW;
+
+    while (true) {
+        int alpha = static_cast<int>(std::max(MIN_SCORE, previousValue - delta));
+        int beta = static_cast<int>(std::min(MAX_SCORE, previousValue + delta));
+
+        Move bestMove = searchRoot(threads[0], depth, moves, alpha, beta, bestValue);
+        if (stopped) {
+            return bestMove;
+        }
+
+        // Wynik poza oknem jest tylko ograniczeniem - powtarzamy z szerszym oknem
+        bool failLow = bestValue <= alpha && alpha > MIN_SCORE;
+        bool failHigh = bestValue >= beta && beta < MAX_SCORE;
+        if (!failLow && !failHigh) {
+            return bestMove;
+        }
+        delta *= 4;
+    }
+}
+
+// Najlepszy dotąd ruch w korzeniu: wynik w starszych 32 bitach (przesunięty tak,
+// żeby porządek liczb bez znaku odpowiadał porządkowi wyników), indeks w młodszych
+static uint64_t packRootBest(int score, int index) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(score) ^ 0x80000000u) << 32) |
+           static_cast<uint32_t>(index);
+}
+
+static int rootBestScore(uint64_t packed) {
+    return static_cast<int>(static_cast<uint32_t>(packed >> 32) ^ 0x80000000u);
+}
+
+static int rootBestIndex(uint64_t packed) {
+    return static_cast<int>(static_cast<uint32_t>(packed));
+}
+
+Move AI::searchRootSplit(int depth, MoveList& moves, int& bestValue) {
+    const int NO_MOVE = MoveList::CAPACITY;
+    std::atomic<uint64_t> best(packRootBest(std::numeric_limits<int>::min(), NO_MOVE));
+
+    std::vector<ThreadPool::Task> tasks;
+    for (int i = 0; i < moves.size(); i++) {
+        tasks.push_back([this, &moves, &best, depth, i](int worker) {
+            SearchThread& thread = threads[worker];
+            uint64_t current = best.load();
+
+            // Ruch musi pobić najlepszy wynik; remis wystarcza, jeśli ruch jest
+            // wcześniej na liście (tak jak pierwszy najlepszy w pętli szeregowej)
+            int alpha = std::numeric_limits<int>::min();
+            if (rootBestIndex(current) != NO_MOVE) {
+                alpha = rootBestScore(current) - (rootBestIndex(current) > i ? 1 : 0);
+            }
+
+            MoveUndo undo;
+            thread.board.applyMove(moves[i], undo);
+            int value = minimax(thread, depth - 1, 1, alpha,
+                                std::numeric_limits<int>::max(), false);
+            thread.board.undoMove(moves[i], undo);
+
+            // Wynik nie większy od alfy to tylko ograniczenie górne
+            if (stopped || value <= alpha) return;
+
+            uint64_t candidate = packRootBest(value, i);
+            current = best.load();
+            while ((value > rootBestScore(current) ||
+                    (value == rootBestScore(current) && i < rootBestIndex(current))) &&
+                   !best.compare_exchange_weak(current, candidate)) {
+            }
+        });
+    }
+    pool->run(tasks);
+
+    uint64_t result = best.load();
+    bestValue = rootBestScore(result);
+    if (stopped || rootBestIndex(result) == NO_MOVE) {
+        return Move();
+    }
+
+    Move bestMove = moves[rootBestIndex(result)];
+    table.store(threads[0].board.getHash(), depth, bestValue, Bound::EXACT,
+                TranspositionTable::packMove(bestMove));
+    return bestMove;
+}
+
+int AI::minimax(SearchThread& thread, int depth, int ply, int alpha, int beta, bool maximizingPlayer) {
+    Board& board = thread.board;
+    SearchStats& stats = thread.stats;
+
+    stats.nodes++;
+    if (checkLimits(thread)) {
+        return 0; // Wynik przerwanej iteracji i tak zostanie odrzucony
+    }
+
     // Warunki końcowe
     if (depth == 0) {
+        if (quiescenceDepth > 0) {
+            return quiescence(thread, quiescenceDepth, ply, alpha, beta, maximizingPlayer);
+        }
         return board.evaluate();
     }
+
+    // Sprawdź tablicę transpozycji
+    uint64_t key = board.getHash();
+    uint16_t hashMove = 0;
+    TTData entry;
+    if (table.probe(key, entry)) {
+        stats.ttHits++;
+        hashMove = entry.move;
+        if (useHashScores && entry.depth >= depth) {
+            if (entry.bound == Bound::EXACT) {
+                stats.ttCutoffs++;
+                return entry.score;
+            }
+            if (entry.bound == Bound::LOWER) alpha = std::max(alpha, entry.score);
+            if (entry.bound == Bound::UPPER) beta = std::min(beta, entry.score);
+            if (beta <= alpha) {
+                stats.ttCutoffs++;
+                return entry.score;
+            }
+        }
+    }
+    int alphaOrig = alpha;
+    int betaOrig = beta;
     
+    // Ruchy etapami: bicia albo ruch z tablicy i zabójcy, a pozostałe
+    // ciche ruchy są generowane dopiero, gdy te nie dadzą odcięcia
+    MovePicker picker(board, maximizingPlayer, thread.ordering, hashMove, ply);
+    Move move;
+
     // Sprawdź czy gra się skończyła
-    auto moves = board.getValidMoves(maximizingPlayer);
-    if (moves.empty()) {
+    if (!picker.next(move)) {
         // Brak ruchów = przegrana
         return maximizingPlayer ? std::numeric_limits<int>::min() + 1 : 
                                  std::numeric_limits<int>::max() - 1;
     }
 
+    // Futility: na węzłach granicznych ciche ruchy nie zmienią oceny o więcej niż margines,
+    // więc gdy ocena statyczna z marginesem nie sięga okna, zostają pominięte.
+    // Przy obowiązkowym biciu wszystkie ruchy są biciami i nic nie jest pomijane.
+    bool futile = false;
+    int futilityValue = 0;
+    if (useFutility && depth == 1 && !picker.capturesForced()) {
+        int staticEval = board.evaluate();
+        if (maximizingPlayer && staticEval + FUTILITY_MARGIN <= alpha) {
+            futile = true;
+            futilityValue = staticEval + FUTILITY_MARGIN;
+        } else if (!maximizingPlayer && staticEval - FUTILITY_MARGIN >= beta) {
+            futile = true;
+            futilityValue = staticEval - FUTILITY_MARGIN;
+        }
+    }
+
+    bool pvs = algorithm == SearchAlgorithm::PVS;
+    int bestEval;
+    uint16_t bestMove = TranspositionTable::packMove(move);
+    int moveIndex = 0;
+    int cutoffIndex = -1;
+
     if (maximizingPlayer) {
         int maxEval = std::numeric_limits<int>::min();
         
-        for (const auto& move : moves) {
-            Board newBoard = board;
-            newBoard.applyMove(move);
-            
-            int eval = minimax(newBoard, depth - 1, alpha, beta, false);
-            maxEval = std::max(maxEval, eval);
+        do {
+            int index = moveIndex++;
+            MoveUndo undo;
+            board.applyMove(move, undo);
+
+            if (futile && !undo.promoted) {
+                // Ruch nie podniesie wyniku ponad futilityValue <= alpha
+                board.undoMove(move, undo);
+                stats.futilityPrunes++;
+                maxEval = std::max(maxEval, futilityValue);
+                continue;
+            }
+
+            int eval;
+            bool searched = false;
+            int reduction = useReductions ? lateMoveReduction(depth, index, move, undo) : 0;
+            if (reduction > 0) {
+                stats.reductions++;
+                eval = minimax(thread, depth - 1 - reduction, ply + 1, alpha, alpha + 1, false);
+                searched = eval <= alpha; // Zgodnie z oczekiwaniem ruch nie jest lepszy
+                if (!searched) stats.reSearches++;
+            }
+
+            if (!searched) {
+                if (pvs && index > 0) {
+                    // Zerowe okno; pełne przeszukanie tylko gdy ruch okaże się lepszy
+                    eval = minimax(thread, depth - 1, ply + 1, alpha, alpha + 1, false);
+                    if (eval > alpha && eval < beta) {
+                        eval = minimax(thread, depth - 1, ply + 1, alpha, beta, false);
+                    }
+                } else {
+                    eval = minimax(thread, depth - 1, ply + 1, alpha, beta, false);
+                }
+            }
+            board.undoMove(move, undo);
+            if (stopped) return 0;
+            if (eval > maxEval) {
+                maxEval = eval;
+                bestMove = TranspositionTable::packMove(move);
+            }
             alpha = std::max(alpha, eval);
             
             if (beta <= alpha) {
+                cutoffIndex = index;
                 break; // Alpha-beta pruning
             }
-        }
+        } while (picker.next(move));
         
-        return maxEval;
+        bestEval = maxEval;
     } else {
         int minEval = std::numeric_limits<int>::max();
         
-        for (const auto& move : moves) {
-            Board newBoard = board;
-            newBoard.applyMove(move);
-            
-            int eval = minimax(newBoard, depth - 1, alpha, beta, true);
-            minEval = std::min(minEval, eval);
+        do {
+            int index = moveIndex++;
+            MoveUndo undo;
+            board.applyMove(move, undo);
+
+            if (futile && !undo.promoted) {
+                board.undoMove(move, undo);
+                stats.futilityPrunes++;
+                minEval = std::min(minEval, futilityValue);
+                continue;
+            }
+
+            int eval;
+            bool searched = false;
+            int reduction = useReductions ? lateMoveReduction(depth, index, move, undo) : 0;
+            if (reduction > 0) {
+                stats.reductions++;
+                eval = minimax(thread, depth - 1 - reduction, ply + 1, beta - 1, beta, true);
+                searched = eval >= beta;
+                if (!searched) stats.reSearches++;
+            }
+
+            if (!searched) {
+                if (pvs && index > 0) {
+                    eval = minimax(thread, depth - 1, ply + 1, beta - 1, beta, true);
+                    if (eval < beta && eval > alpha) {
+                        eval = minimax(thread, depth - 1, ply + 1, alpha, beta, true);
+                    }
+                } else {
+                    eval = minimax(thread, depth - 1, ply + 1, alpha, beta, true);
+                }
+            }
+            board.undoMove(move, undo);
+            if (stopped) return 0;
+            if (eval < minEval) {
+                minEval = eval;
+                bestMove = TranspositionTable::packMove(move);
+            }
             beta = std::min(beta, eval);
             
             if (beta <= alpha) {
+                cutoffIndex = index;
                 break; // Alpha-beta pruning
             }
-        }
+        } while (picker.next(move));
         
-        return minEval;
+        bestEval = minEval;
+    }
+
+    if (cutoffIndex >= 0) {
+        stats.cutoffs++;
+        if (cutoffIndex == 0) stats.firstMoveCutoffs++;
+        thread.ordering.recordCutoff(move, ply, depth); // move to wciąż ruch, który dał odcięcie
+    }
+
+    // Zapisz wynik razem z rodzajem granicy względem początkowego okna
+    Bound bound = Bound::EXACT;
+    if (bestEval <= alphaOrig) {
+        bound = Bound::UPPER;
+    } else if (bestEval >= betaOrig) {
+        bound = Bound::LOWER;
+    }
+    table.store(key, depth, bestEval, bound, bestMove);
+
+    return bestEval;
+}
+
+int AI::lateMoveReduction(int depth, int moveIndex, const Move& move, const MoveUndo& undo) {
+    const int MIN_DEPTH = 3;       // płycej redukcja nie ma czego oszczędzać
+    const int FULL_DEPTH_MOVES = 3; // ruch z tablicy, zabójcy i najlepsze z historii
+
+    // Bicia i promocje zmieniają materiał, więc zawsze są przeszukiwane w pełni
+    if (depth < MIN_DEPTH || moveIndex < FULL_DEPTH_MOVES || move.isCapture() || undo.promoted) {
+        return 0;
+    }
+    return (depth >= 6 && moveIndex >= 8) ? 2 : 1;
+}
+
+int AI::quiescence(SearchThread& thread, int depth, int ply, int alpha, int beta, bool maximizingPlayer) {
+    Board& board = thread.board;
+    thread.stats.qnodes++;
+    if (checkLimits(thread)) {
+        return 0; // Wynik przerwanej iteracji i tak zostanie odrzucony
+    }
+
+    // Bez obowiązkowego bicia pozycja jest spokojna (stand-pat). Przy biciu
+    // nie ma tej możliwości - strona na ruchu musi bić.
+    if (depth == 0 || !board.hasCaptures(maximizingPlayer)) {
+        return board.evaluate();
+    }
+
+    MoveList moves;
+    board.generateMoves(maximizingPlayer, moves);
+    thread.ordering.order(moves, 0, ply);
+
+    int bestEval = maximizingPlayer ? std::numeric_limits<int>::min()
+                                    : std::numeric_limits<int>::max();
+    for (const auto& move : moves) {
+        MoveUndo undo;
+        board.applyMove(move, undo);
+        int eval = quiescence(thread, depth - 1, ply + 1, alpha, beta, !maximizingPlayer);
+        board.undoMove(move, undo);
+        if (stopped) return 0;
+
+        if (maximizingPlayer) {
+            bestEval = std::max(bestEval, eval);
+            alpha = std::max(alpha, eval);
+        } else {
+            bestEval = std::min(bestEval, eval);
+            beta = std::min(beta, eval);
+        }
+        if (beta <= alpha) {
+            break;
+        }
     }
+
+    return bestEval;
 }
 
-Move AI::getBestMove(Board board, Difficulty difficulty) {
+Move AI::getBestMove(const Board& board, Difficulty difficulty) {
     return getBestMove(board, static_cast<int>(difficulty));
-}
\ No newline at end of file
+}
+
+static bool samePosition(const Board& a, const Board& b) {
+    return a.getHash() == b.getHash() &&
+           a.getMen(true) == b.getMen(true) && a.getMen(false) == b.getMen(false) &&
+           a.getKings(true) == b.getKings(true) && a.getKings(false) == b.getKings(false);
+}
+
+void AsyncSearch::start(const Board& board, const SearchLimits& limits) {
+    cancel();
+
+    SearchLimits searchLimits = limits;
+    searchLimits.stop = &stop;
+    stop = false;
+
+    // Wątek dostaje własną kopię planszy, więc wywołujący może ją dalej zmieniać
+    AI& engine = ai;
+    result = std::async(std::launch::async, [&engine, board, searchLimits]() {
+        return engine.search(board, searchLimits);
+    });
+}
+
+bool AsyncSearch::ponder(const Board& board, const SearchLimits& limits) {
+    cancel();
+
+    Move reply;
+    if (!ai.getPonderMove(board, reply)) return false;
+
+    expected = board;
+    expected.applyMove(reply);
+    if (!expected.hasValidMoves(true)) return false;
+
+    start(expected, limits);
+    pondering = true;
+    return true;
+}
+
+bool AsyncSearch::playerMoved(const Board& board) {
+    if (!pondering) return false;
+
+    pondering = false;
+    if (samePosition(board, expected)) return true;
+
+    cancel();
+    return false;
+}
+
+bool AsyncSearch::ready() const {
+    return result.valid() && result.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready;
+}
+
+Move AsyncSearch::get() {
+    pondering = false;
+    return result.get();
+}
+
+void AsyncSearch::cancel() {
+    pondering = false;
+    if (!result.valid()) return;
+
+    // Przeszukiwanie sprawdza flagę co 1024 węzły, więc kończy się prawie od razu
+    stop = true;
+    result.get();
+}
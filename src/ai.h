@@ -1,7 +1,18 @@
 #ifndef AI_H
 #define AI_H
 
+#include <cstdint>
+#include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
 #include "board.h"
+#include "tt.h"
+#include "moveorder.h"
+#include "threadpool.h"
 
 enum class Difficulty {
     EASY = 2,    // głębokość 2
@@ -9,13 +20,194 @@ enum class Difficulty {
     HARD = 8     // głębokość 8
 };
 
+// Sposób wykorzystania wielu wątków
+enum class ParallelMode {
+    LAZY_SMP,   // wątki pomocnicze na wspólnej tablicy transpozycji
+    ROOT_SPLIT  // ruchy w korzeniu rozdzielane między wątki puli
+};
+
+// Algorytm przeszukiwania drzewa gry
+enum class SearchAlgorithm {
+    ALPHA_BETA,  // każdy ruch z pełnym oknem (alpha, beta)
+    PVS          // Principal Variation Search: pełne okno dla pierwszego ruchu, zerowe dla pozostałych
+};
+
+// Ograniczenia przeszukiwania z pogłębianiem iteracyjnym (0 = bez limitu)
+struct SearchLimits {
+    static const int MAX_DEPTH = 64;
+
+    int maxDepth = MAX_DEPTH;  // najgłębsza iteracja
+    int64_t timeMs = 0;        // budżet czasu w milisekundach
+    uint64_t nodes = 0;        // budżet węzłów (razem z węzłami quiescence)
+    // Flaga przerwania ustawiana z innego wątku (np. GUI); sprawdzana razem z budżetami
+    const std::atomic<bool>* stop = nullptr;
+};
+
+// Statystyki ostatniego przeszukiwania
+struct SearchStats {
+    uint64_t nodes = 0;      // odwiedzone węzły
+    uint64_t ttHits = 0;     // pozycje znalezione w tablicy transpozycji
+    uint64_t ttCutoffs = 0;  // węzły zakończone wynikiem z tablicy
+    uint64_t cutoffs = 0;          // odcięcia alfa-beta
+    uint64_t firstMoveCutoffs = 0; // odcięcia już na pierwszym ruchu (jakość kolejności)
+    uint64_t qnodes = 0;     // węzły przeszukiwania bić na liściach (quiescence)
+    uint64_t reductions = 0;     // późne ruchy przeszukane płycej (LMR)
+    uint64_t reSearches = 0;     // zredukowane ruchy powtórzone na pełnej głębokości
+    uint64_t futilityPrunes = 0; // ciche ruchy pominięte na węzłach granicznych
+    int depth = 0;           // głębokość ostatniej ukończonej iteracji
+};
+
 class AI {
 public:
-    Move getBestMove(Board board, Difficulty difficulty);
-    Move getBestMove(Board board, int depth = 5);
+    static const int DEFAULT_QUIESCENCE_DEPTH = 12;
+    static const int ASPIRATION_WINDOW = 20; // początkowa połowa okna aspiracyjnego (dwa pionki)
+    static const int FUTILITY_MARGIN = 30;   // największy spodziewany zysk cichego ruchu (trzy pionki)
+
+    AI();
+
+    Move getBestMove(const Board& board, Difficulty difficulty);
+    Move getBestMove(const Board& board, int depth = 5);
+
+    // Pogłębianie iteracyjne do wyczerpania budżetu czasu lub węzłów.
+    // Zwraca najlepszy ruch z najgłębszej ukończonej iteracji.
+    Move search(const Board& board, const SearchLimits& limits);
+
+    // Rozmiar tablicy transpozycji w MB; tablica jest zachowywana między ruchami
+    void setHashSize(size_t megabytes) { table.resize(megabytes); }
+    void clearHash() { table.clear(); }
+
+    // Kolejne przeszukiwania jednej partii korzystają z poprzednich: tablica transpozycji
+    // (stare wpisy są zastępowane w pierwszej kolejności), historia odcięć o zmniejszonej
+    // wadze i główny wariant, którego ruchy wracają do tablicy. Nowa partia zaczyna od zera.
+    void newGame();
+
+    // Liczba wątków przeszukiwania (Lazy SMP). Wątki pomocnicze przeszukują ten sam
+    // korzeń na przesuniętych głębokościach i dzielą się wynikami przez tablicę transpozycji.
+    void setThreads(int count);
+    int getThreads() const { return static_cast<int>(threads.size()); }
+
+    // Podział korzenia: ruchy w korzeniu są zadaniami puli z kradzieżą pracy,
+    // a najlepszy dotąd wynik zawęża okno kolejnych ruchów. W trybie
+    // deterministycznym (domyślnym) wynik jest taki sam jak przy jednym wątku,
+    // bo tablica transpozycji służy wtedy tylko do kolejności ruchów, a LMR i futility
+    // pruning są wyłączone.
+    void setParallelMode(ParallelMode mode) { parallelMode = mode; }
+    void setDeterministic(bool enabled) { deterministic = enabled; }
+
+    // PVS dodatkowo przeszukuje korzeń pogłębiania iteracyjnego oknem aspiracyjnym
+    // wokół wyniku poprzedniej iteracji
+    void setAlgorithm(SearchAlgorithm searchAlgorithm) { algorithm = searchAlgorithm; }
+
+    // Na liściach przeszukiwanie jest kontynuowane, dopóki bicie jest obowiązkowe
+    // (najwyżej maxDepth kolejnych bić), zamiast oceniać pozycję w trakcie wymiany
+    void setQuiescence(bool enabled, int maxDepth = DEFAULT_QUIESCENCE_DEPTH) {
+        quiescenceDepth = enabled ? std::max(1, maxDepth) : 0;
+    }
+
+    // Przycinanie selektywne, domyślnie wyłączone:
+    // LMR - późne ciche ruchy (od głębokości 3) najpierw płycej, z zerowym oknem;
+    //       ruch, który mimo to poprawia wynik, jest przeszukiwany ponownie na pełnej głębokości,
+    // futility - na głębokości 1 pomija ciche ruchy, gdy ocena statyczna z marginesem
+    //       FUTILITY_MARGIN nie sięga okna
+    void setLateMoveReductions(bool enabled) { lateMoveReductions = enabled; }
+    void setFutilityPruning(bool enabled) { futilityPruning = enabled; }
+
+    // Statystyki zsumowane ze wszystkich wątków
+    const SearchStats& getStats() const { return stats; }
+
+    // Przewidywana odpowiedź gracza na pozycji po ruchu AI (gracz na ruchu): najlepszy
+    // ruch z tablicy transpozycji albo jedyny legalny ruch; false, gdy nie da się zgadnąć
+    bool getPonderMove(const Board& board, Move& move) const;
+
+private:
+    // Stan prywatny jednego wątku przeszukiwania
+    struct SearchThread {
+        int id = 0;           // 0 = wątek główny
+        Board board;          // własna kopia planszy (wykonaj/cofnij ruch w miejscu)
+        MoveOrdering ordering;
+        SearchStats stats;
+    };
+
+    TranspositionTable table;
+    std::vector<SearchThread> threads;
+    std::unique_ptr<ThreadPool> pool; // tylko dla ROOT_SPLIT z więcej niż jednym wątkiem
+    SearchStats stats;
+
+    // Główny wariant ostatniego przeszukiwania: (hash pozycji, ruch z niej)
+    std::vector<std::pair<uint64_t, uint16_t>> principalVariation;
+
+    SearchAlgorithm algorithm = SearchAlgorithm::ALPHA_BETA;
+    ParallelMode parallelMode = ParallelMode::LAZY_SMP;
+    bool deterministic = true;
+    int quiescenceDepth = DEFAULT_QUIESCENCE_DEPTH; // 0 = ocena statyczna na liściach
+    bool lateMoveReductions = false;
+    bool futilityPruning = false;
+
+    // Stan bieżącego przeszukiwania
+    SearchLimits limits;
+    std::chrono::steady_clock::time_point startTime;
+    std::atomic<bool> stopped{false};
+    std::atomic<uint64_t> sharedNodes{0}; // węzły wszystkich wątków, liczone paczkami po 1024
+    bool useHashScores = true;            // false: tablica tylko podpowiada ruch
+    bool useReductions = false;           // LMR w bieżącym przeszukiwaniu
+    bool useFutility = false;             // futility pruning w bieżącym przeszukiwaniu
+
+    void startSearch(const Board& board, const SearchLimits& searchLimits);
+    bool checkLimits(SearchThread& thread);
+    void collectStats();
+    void savePrincipalVariation();
+    void seedPrincipalVariation(const Board& root);
+    bool rootSplitActive() const;
+
+    // Wątki pomocnicze działają od startHelpers do stopHelpers
+    void startHelpers(std::vector<std::thread>& helpers, const MoveList& rootMoves);
+    void stopHelpers(std::vector<std::thread>& helpers);
+    void helperSearch(SearchThread& thread, MoveList rootMoves);
+
+    Move searchRoot(SearchThread& thread, int depth, MoveList& moves, int alpha, int beta, int& bestValue);
+    Move searchAspiration(int depth, MoveList& moves, int previousValue, int& bestValue);
+    Move searchRootSplit(int depth, MoveList& moves, int& bestValue);
+
+    // Przeszukuje planszę wątku w miejscu: każdy ruch jest wykonywany i cofany na tej samej planszy
+    int minimax(SearchThread& thread, int depth, int ply, int alpha, int beta, bool maximizingPlayer);
+
+    // Redukcja głębokości dla ruchu o danym indeksie (0 = pełna głębokość)
+    static int lateMoveReduction(int depth, int moveIndex, const Move& move, const MoveUndo& undo);
+
+    // Przeszukiwanie samych bić; bez obowiązkowego bicia zwraca ocenę statyczną
+    int quiescence(SearchThread& thread, int depth, int ply, int alpha, int beta, bool maximizingPlayer);
+};
+
+// Przeszukiwanie AI w osobnym wątku, z wynikiem odbieranym jak z future.
+// Pondering: po ruchu AI od razu liczymy odpowiedź na przewidywany ruch gracza,
+// wypełniając przy tym tablicę transpozycji. Gdy gracz wykona ten ruch, przeszukiwanie
+// trwa dalej jako zwykłe i zwykle jest już skończone; w przeciwnym razie jest
+// przerywane, a właściwe korzysta z wpisów tablicy dla wspólnych poddrzew.
+// Obiektu AI nie wolno używać z innego wątku, dopóki przeszukiwanie jest aktywne.
+class AsyncSearch {
+public:
+    explicit AsyncSearch(AI& engine) : ai(engine) {}
+    ~AsyncSearch() { cancel(); }
+
+    void start(const Board& board, const SearchLimits& limits);
+    // board: pozycja po ruchu AI; false, gdy nie ma czego przewidywać
+    bool ponder(const Board& board, const SearchLimits& limits);
+    // Pozycja po ruchu gracza; true, gdy zgadza się z przewidywaną i przeszukiwanie
+    // trwa dalej, w przeciwnym razie pondering jest przerywany
+    bool playerMoved(const Board& board);
+
+    bool active() const { return result.valid(); }
+    bool isPondering() const { return pondering; }
+    bool ready() const;
+    Move get(); // czeka na zakończenie przeszukiwania
+    void cancel(); // przerywa przeszukiwanie i czeka na zakończenie wątku
 
 private:
-    int minimax(Board board, int depth, int alpha, int beta, bool maximizingPlayer);
+    AI& ai;
+    std::future<Move> result;
+    std::atomic<bool> stop{false};
+    bool pondering = false;
+    Board expected; // pozycja przeszukiwana w trakcie ponderingu
 };
 
-#endif // AI_H
\ No newline at end of file
+#endif // AI_H
@@ -0,0 +1,143 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+
+// Maska bitowa 32 ciemnych pól planszy.
+// Pole (row, col), dla którego (row + col) % 2 == 1, ma indeks row * 4 + col / 2,
+// więc kolejność bitów odpowiada przeglądaniu planszy wierszami.
+typedef uint32_t Bitboard;
+
+// Kierunki w tej samej kolejności co dawne wektory {{-1,-1}, {-1,1}, {1,-1}, {1,1}}
+enum Direction {
+    DIR_UP_LEFT = 0,    // w górę planszy (ruch gracza)
+    DIR_UP_RIGHT = 1,
+    DIR_DOWN_LEFT = 2,  // w dół planszy (ruch AI)
+    DIR_DOWN_RIGHT = 3
+};
+
+const Bitboard EVEN_ROWS = 0x0F0F0F0Fu;   // wiersze 0, 2, 4, 6 (kolumny 1, 3, 5, 7)
+const Bitboard ODD_ROWS  = 0xF0F0F0F0u;   // wiersze 1, 3, 5, 7 (kolumny 0, 2, 4, 6)
+const Bitboard LEFT_EDGE = 0x10101010u;   // kolumna 0
+const Bitboard RIGHT_EDGE = 0x08080808u;  // kolumna 7
+const Bitboard TOP_ROW = 0x0000000Fu;     // wiersz 0 (promocja gracza)
+const Bitboard BOTTOM_ROW = 0xF0000000u;  // wiersz 7 (promocja AI)
+
+// Wiersz promocji indeksowany stroną jak w Board: [0] = gracz, [1] = AI
+constexpr Bitboard PROMOTION_ROW[2] = {TOP_ROW, BOTTOM_ROW};
+
+constexpr int oppositeDirection(int dir) { return DIR_DOWN_RIGHT - dir; }
+
+// Stałe strony znane w czasie kompilacji, dzięki którym generowanie ruchów
+// specjalizowane szablonem nie sprawdza koloru w pętlach
+template<bool ForAI> struct Side;
+
+template<> struct Side<true> {
+    static constexpr int INDEX = 1;
+    static constexpr int FORWARD_LEFT = DIR_DOWN_LEFT;  // pionki AI idą w dół planszy
+    static constexpr int FORWARD_RIGHT = DIR_DOWN_RIGHT;
+};
+
+template<> struct Side<false> {
+    static constexpr int INDEX = 0;
+    static constexpr int FORWARD_LEFT = DIR_UP_LEFT;
+    static constexpr int FORWARD_RIGHT = DIR_UP_RIGHT;
+};
+
+constexpr bool isDarkSquare(int row, int col) { return (row + col) % 2 == 1; }
+constexpr int squareIndex(int row, int col) { return row * 4 + col / 2; }
+constexpr int squareRow(int sq) { return sq >> 2; }
+constexpr int squareCol(int sq) { return ((sq & 3) << 1) + (~(sq >> 2) & 1); }
+constexpr Bitboard squareBit(int sq) { return Bitboard(1) << sq; }
+
+inline int popCount(Bitboard b) { return __builtin_popcount(b); }
+inline int lowestSquare(Bitboard b) { return __builtin_ctz(b); }
+inline int highestSquare(Bitboard b) { return 31 - __builtin_clz(b); }
+inline int popLowestSquare(Bitboard& b) {
+    int sq = __builtin_ctz(b);
+    b &= b - 1;
+    return sq;
+}
+
+// Przesunięcie wszystkich pól maski o jedno pole po przekątnej.
+// Wiersze parzyste i nieparzyste mają inne przesunięcia, a pola wychodzące
+// poza planszę są odcinane maskami krawędzi.
+inline Bitboard shiftUpLeft(Bitboard b) {
+    return ((b & EVEN_ROWS & ~TOP_ROW) >> 4) | ((b & ODD_ROWS & ~LEFT_EDGE) >> 5);
+}
+
+inline Bitboard shiftUpRight(Bitboard b) {
+    return ((b & EVEN_ROWS & ~TOP_ROW & ~RIGHT_EDGE) >> 3) | ((b & ODD_ROWS) >> 4);
+}
+
+inline Bitboard shiftDownLeft(Bitboard b) {
+    return ((b & EVEN_ROWS) << 4) | ((b & ODD_ROWS & ~LEFT_EDGE & ~BOTTOM_ROW) << 3);
+}
+
+inline Bitboard shiftDownRight(Bitboard b) {
+    return ((b & EVEN_ROWS & ~RIGHT_EDGE) << 5) | ((b & ODD_ROWS & ~BOTTOM_ROW) << 4);
+}
+
+inline Bitboard shift(Bitboard b, int dir) {
+    switch (dir) {
+        case DIR_UP_LEFT: return shiftUpLeft(b);
+        case DIR_UP_RIGHT: return shiftUpRight(b);
+        case DIR_DOWN_LEFT: return shiftDownLeft(b);
+        default: return shiftDownRight(b);
+    }
+}
+
+// Sąsiedzi, pola lądowania przy biciu i całe promienie przekątnych dla każdego pola
+// i kierunku ([pole][kierunek]), liczone w czasie kompilacji. Poza planszą: 0.
+struct DiagonalTables {
+    Bitboard neighbour[32][4]; // pole obok
+    Bitboard jump[32][4];      // pole za sąsiadem, na które ląduje bijący pionek
+    Bitboard ray[32][4];       // wszystkie pola aż do krawędzi planszy
+
+    constexpr DiagonalTables() : neighbour(), jump(), ray() {
+        for (int sq = 0; sq < 32; sq++) {
+            for (int dir = DIR_UP_LEFT; dir <= DIR_DOWN_RIGHT; dir++) {
+                int rowStep = dir >= DIR_DOWN_LEFT ? 1 : -1;
+                int colStep = dir % 2 == 1 ? 1 : -1;
+                int row = squareRow(sq) + rowStep;
+                int col = squareCol(sq) + colStep;
+                for (int step = 1; row >= 0 && row < 8 && col >= 0 && col < 8; step++) {
+                    Bitboard bit = squareBit(squareIndex(row, col));
+                    ray[sq][dir] |= bit;
+                    if (step == 1) neighbour[sq][dir] = bit;
+                    if (step == 2) jump[sq][dir] = bit;
+                    row += rowStep;
+                    col += colStep;
+                }
+            }
+        }
+    }
+};
+
+constexpr DiagonalTables DIAGONALS;
+
+// Pole maski najbliższe początkowi promienia w danym kierunku
+// (w dół planszy numery pól rosną, w górę maleją); 0 dla pustej maski
+inline Bitboard nearestOnRay(Bitboard squares, int dir) {
+    if (!squares) return 0;
+    return dir >= DIR_DOWN_LEFT ? squares & (~squares + 1) : squareBit(highestSquare(squares));
+}
+
+// Puste pola, na które damka może przejść z pola sq w kierunku dir
+inline Bitboard kingReach(int sq, int dir, Bitboard occupied) {
+    Bitboard ray = DIAGONALS.ray[sq][dir];
+    Bitboard blocker = nearestOnRay(ray & occupied, dir);
+    if (blocker) {
+        ray &= ~(blocker | DIAGONALS.ray[lowestSquare(blocker)][dir]);
+    }
+    return ray;
+}
+
+// Przesunięcie w kierunku znanym w czasie kompilacji, bez wyboru w switch
+template<int Dir> inline Bitboard shift(Bitboard b);
+template<> inline Bitboard shift<DIR_UP_LEFT>(Bitboard b) { return shiftUpLeft(b); }
+template<> inline Bitboard shift<DIR_UP_RIGHT>(Bitboard b) { return shiftUpRight(b); }
+template<> inline Bitboard shift<DIR_DOWN_LEFT>(Bitboard b) { return shiftDownLeft(b); }
+template<> inline Bitboard shift<DIR_DOWN_RIGHT>(Bitboard b) { return shiftDownRight(b); }
+
+#endif // BITBOARD_H
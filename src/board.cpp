@@ -3,323 +3,470 @@
 #include <algorithm>
 #include <cmath>
 
+// Losowe klucze Zobrista: [strona * 2 + damka][pole] oraz klucz strony na ruchu.
+// Generowane deterministycznie (splitmix64), więc hash pozycji jest stały między uruchomieniami.
+struct ZobristKeys {
+    uint64_t pieces[4][32];
+    uint64_t aiToMove;
+
+    ZobristKeys() {
+        uint64_t state = 0x9E3779B97F4A7C15ull;
+        for (int type = 0; type < 4; type++) {
+            for (int sq = 0; sq < 32; sq++) {
+                pieces[type][sq] = next(state);
+            }
+        }
+        aiToMove = next(state);
+    }
+
+    static uint64_t next(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+};
+
+static const ZobristKeys zobrist;
+
+// Składniki oceny zależne tylko od pionka i pola, ze znakiem (dodatnie dla AI):
+// wartość, awans pionka, centrum i stała kara za samotność (pola obok w tym samym
+// wierszu są zawsze jasne, więc dotyczy każdego pionka)
+struct PieceSquareTable {
+    int values[4][32]; // [strona * 2 + damka][pole]
+
+    PieceSquareTable() {
+        for (int s = 0; s < 2; s++) {
+            for (int king = 0; king < 2; king++) {
+                for (int sq = 0; sq < 32; sq++) {
+                    int row = squareRow(sq);
+                    int col = squareCol(sq);
+                    int value = king ? 50 : 10;
+                    if (!king) {
+                        value += s == 1 ? row : 7 - row;
+                    }
+                    value += 3 - std::abs(3 - col);
+                    value -= 2;
+                    values[s * 2 + king][sq] = s == 1 ? value : -value;
+                }
+            }
+        }
+    }
+};
+
+static const PieceSquareTable pieceSquare;
+
+static uint64_t pieceKey(int s, bool isKing, int sq) {
+    return zobrist.pieces[s * 2 + (isKing ? 1 : 0)][sq];
+}
+
+// Suma kluczy wszystkich pól z maski
+static uint64_t maskKey(int s, bool isKing, Bitboard mask) {
+    uint64_t key = 0;
+    while (mask) {
+        key ^= pieceKey(s, isKing, popLowestSquare(mask));
+    }
+    return key;
+}
+
 Board::Board() {
     init();
 }
 
 void Board::init() {
     // Wyczyść planszę
-    for (int i = 0; i < SIZE; i++) {
-        for (int j = 0; j < SIZE; j++) {
-            cells[i][j] = nullptr;
-        }
-    }
-    
+    men[0] = men[1] = 0;
+    kings[0] = kings[1] = 0;
+    hashKey = 0;
+    aiToMove = false; // Gracz zaczyna
+    pieceSquareScore = 0;
+
     // Umieść pionki gracza (na dole, wiersze 5-7)
     for (int row = 5; row < 8; row++) {
         for (int col = 0; col < SIZE; col++) {
-            if ((row + col) % 2 == 1) { // Tylko na ciemnych polach
-                cells[row][col] = std::make_shared<Piece>(false, false);
+            if (isDarkSquare(row, col)) { // Tylko na ciemnych polach
+                addPiece(side(false), false, squareIndex(row, col));
             }
         }
     }
-    
+
     // Umieść pionki AI (na górze, wiersze 0-2)
     for (int row = 0; row < 3; row++) {
         for (int col = 0; col < SIZE; col++) {
-            if ((row + col) % 2 == 1) { // Tylko na ciemnych polach
-                cells[row][col] = std::make_shared<Piece>(true, false);
+            if (isDarkSquare(row, col)) { // Tylko na ciemnych polach
+                addPiece(side(true), false, squareIndex(row, col));
             }
         }
     }
+
+    threats = threatsIn(~Bitboard(0));
+    BOARD_CHECK(hashKey == computeHash());
 }
 
 std::vector<Move> Board::getValidMoves(bool forAI) const {
-    std::vector<Move> allMoves;
-    std::vector<Move> captureMoves;
-    
-    // Znajdź wszystkie możliwe ruchy
-    for (int row = 0; row < SIZE; row++) {
-        for (int col = 0; col < SIZE; col++) {
-            if (cells[row][col] && cells[row][col]->getIsAI() == forAI) {
-                auto pieceMoves = getPieceMovesAndCaptures(row, col, forAI);
-                for (const auto& move : pieceMoves) {
-                    if (!move.capturedPositions.empty()) {
-                        captureMoves.push_back(move);
-                    } else {
-                        allMoves.push_back(move);
-                    }
-                }
-            }
-        }
-    }
-    
-    // Jeśli są bicia, zwróć tylko bicia (zgodnie z regułami warcabów)
-    if (!captureMoves.empty()) {
-        return captureMoves;
-    }
-    
-    return allMoves;
+    MoveList moves;
+    generateMoves(forAI, moves);
+    return std::vector<Move>(moves.begin(), moves.end());
 }
 
-std::vector<Move> Board::getPieceMovesAndCaptures(int row, int col, bool forAI) const {
-    std::vector<Move> moves;
-    auto piece = cells[row][col];
-    
-    if (!piece || piece->getIsAI() != forAI) {
-        return moves;
-    }
-    
-    // Kierunki ruchu dla zwykłych pionków
-    std::vector<std::pair<int, int>> directions;
-    
-    if (piece->getIsKing()) {
-        // Damka może się poruszać we wszystkich kierunkach
-        directions = {{-1, -1}, {-1, 1}, {1, -1}, {1, 1}};
-    } else {
-        // Zwykły pionek
-        if (forAI) {
-            // AI porusza się w dół
-            directions = {{1, -1}, {1, 1}};
-        } else {
-            // Gracz porusza się w górę
-            directions = {{-1, -1}, {-1, 1}};
+template<bool ForAI>
+void Board::generateMoves(MoveList& moves) const {
+    moves.clear();
+
+    // Jeśli są bicia, generuj tylko bicia (zgodnie z regułami warcabów).
+    // Bity przeglądamy od najniższego, czyli w kolejności wierszy planszy.
+    Bitboard capturers = getCapturers<ForAI>();
+    if (capturers) {
+        while (capturers) {
+            getCaptureMoves<ForAI>(popLowestSquare(capturers), moves);
         }
+        return;
     }
-    
-    // Najpierw sprawdź bicia
-    std::vector<Move> captureMoves = getCaptureMoves(row, col, forAI);
-    if (!captureMoves.empty()) {
-        return captureMoves;
+
+    Bitboard own = pieces(ForAI);
+    while (own) {
+        getSimpleMoves<ForAI>(popLowestSquare(own), moves);
     }
-    
-    // Jeśli nie ma bić, dodaj zwykłe ruchy
-    return getSimpleMoves(row, col, forAI);
 }
 
-std::vector<Move> Board::getCaptureMoves(int row, int col, bool forAI) const {
-    return getMultiCaptureMoves(row, col, forAI);
+template<bool ForAI>
+bool Board::hasCaptures() const {
+    return getCapturers<ForAI>() != 0;
 }
 
-std::vector<Move> Board::getSimpleMoves(int row, int col, bool forAI) const {
-    std::vector<Move> simpleMoves;
-    auto piece = cells[row][col];
-    
-    if (!piece) return simpleMoves;
-    
-    std::vector<std::pair<int, int>> directions;
-    if (piece->getIsKing()) {
-        directions = {{-1, -1}, {-1, 1}, {1, -1}, {1, 1}};
-    } else {
-        if (forAI) {
-            directions = {{1, -1}, {1, 1}};
-        } else {
-            directions = {{-1, -1}, {-1, 1}};
+template<bool ForAI>
+Bitboard Board::getCapturers() const {
+    typedef Side<ForAI> S;
+    Bitboard ownMen = men[S::INDEX];
+    Bitboard enemy = pieces(!ForAI);
+    Bitboard empty = ~occupied();
+
+    // Pionki: przeciwnik na sąsiednim polu do przodu i puste pole za nim.
+    // Pole lądowania cofamy o dwa pola, aby otrzymać bijące pionki.
+    const int LEFT = S::FORWARD_LEFT;
+    const int RIGHT = S::FORWARD_RIGHT;
+    Bitboard landingLeft = shift<LEFT>(shift<LEFT>(ownMen) & enemy) & empty;
+    Bitboard landingRight = shift<RIGHT>(shift<RIGHT>(ownMen) & enemy) & empty;
+    Bitboard capturers = shift<oppositeDirection(LEFT)>(shift<oppositeDirection(LEFT)>(landingLeft)) |
+                         shift<oppositeDirection(RIGHT)>(shift<oppositeDirection(RIGHT)>(landingRight));
+
+    // Damki sprawdzamy pojedynczo, bo bicie może być z dystansu
+    Bitboard ownKings = kings[S::INDEX];
+    while (ownKings) {
+        int sq = popLowestSquare(ownKings);
+        int enemySq, jumpSq;
+        for (int dir = DIR_UP_LEFT; dir <= DIR_DOWN_RIGHT; dir++) {
+            if (canCaptureKing<ForAI>(sq, dir, enemySq, jumpSq)) {
+                capturers |= squareBit(sq);
+                break;
+            }
         }
     }
-    
-    for (const auto& dir : directions) {
-        if (piece->getIsKing()) {
-            // Damka może się poruszać na dowolną odległość
-            for (int distance = 1; distance < SIZE; distance++) {
-                int newRow = row + dir.first * distance;
-                int newCol = col + dir.second * distance;
-                
-                if (!isValidPosition(newRow, newCol)) break;
-                if (cells[newRow][newCol]) break; // Pole zajęte
-                
-                simpleMoves.push_back(Move(row, col, newRow, newCol));
+
+    return capturers;
+}
+
+template<bool ForAI>
+void Board::getCaptureMoves(int sq, MoveList& moves) const {
+    Bitboard from = squareBit(sq);
+    if (!(pieces(ForAI) & from)) return;
+
+    // Jedna ścieżka bić budowana w miejscu; pole startowe zwalnia się po wyruszeniu pionka
+    Move path(squareRow(sq), squareCol(sq), squareRow(sq), squareCol(sq));
+    bool isKing = (kings[Side<ForAI>::INDEX] & from) != 0;
+    getMultiCaptureMoves<ForAI>(sq, isKing, occupied() & ~from, path, moves);
+}
+
+template<bool ForAI>
+void Board::getSimpleMoves(int sq, MoveList& moves) const {
+    typedef Side<ForAI> S;
+    Bitboard from = squareBit(sq);
+
+    if (!(pieces(ForAI) & from)) return;
+
+    int row = squareRow(sq);
+    int col = squareCol(sq);
+    Bitboard occ = occupied();
+    if (kings[S::INDEX] & from) {
+        // Damka może się poruszać na dowolną odległość; pola od najbliższego
+        for (int dir = DIR_UP_LEFT; dir <= DIR_DOWN_RIGHT; dir++) {
+            Bitboard reach = kingReach(sq, dir, occ);
+            while (reach) {
+                Bitboard to = nearestOnRay(reach, dir);
+                reach ^= to;
+                int dst = lowestSquare(to);
+                moves.push(Move(row, col, squareRow(dst), squareCol(dst)));
             }
-        } else {
-            // Zwykły pionek - tylko jedno pole
-            int newRow = row + dir.first;
-            int newCol = col + dir.second;
-            
-            if (isValidMove(row, col, newRow, newCol, forAI)) {
-                simpleMoves.push_back(Move(row, col, newRow, newCol));
+        }
+    } else {
+        // Zwykły pionek - tylko jedno pole do przodu
+        Bitboard targets[2] = {DIAGONALS.neighbour[sq][S::FORWARD_LEFT] & ~occ,
+                               DIAGONALS.neighbour[sq][S::FORWARD_RIGHT] & ~occ};
+        for (Bitboard to : targets) {
+            if (to) {
+                int dst = lowestSquare(to);
+                moves.push(Move(row, col, squareRow(dst), squareCol(dst)));
             }
         }
     }
-    
-    return simpleMoves;
-}
-
-bool Board::canCapture(int row, int col, int deltaRow, int deltaCol, bool forAI) const {
-    int enemyRow = row + deltaRow;
-    int enemyCol = col + deltaCol;
-    int jumpRow = row + 2 * deltaRow;
-    int jumpCol = col + 2 * deltaCol;
-    
-    // Sprawdź czy pozycje są w granicach planszy
-    if (!isValidPosition(enemyRow, enemyCol) || !isValidPosition(jumpRow, jumpCol)) {
-        return false;
-    }
-    
-    // Sprawdź czy na pozycji enemy jest przeciwnik
-    if (!cells[enemyRow][enemyCol] || cells[enemyRow][enemyCol]->getIsAI() == forAI) {
+}
+
+template<bool ForAI>
+bool Board::isLegalQuietMove(const Move& move) const {
+    typedef Side<ForAI> S;
+    if (move.isCapture() ||
+        !isValidPosition(move.srcRow, move.srcCol) || !isValidPosition(move.dstRow, move.dstCol) ||
+        !isDarkSquare(move.srcRow, move.srcCol) || !isDarkSquare(move.dstRow, move.dstCol)) {
         return false;
     }
-    
-    // Sprawdź czy pozycja docelowa jest pusta
-    if (cells[jumpRow][jumpCol]) {
+
+    int src = squareIndex(move.srcRow, move.srcCol);
+    Bitboard from = squareBit(src);
+    Bitboard to = squareBit(squareIndex(move.dstRow, move.dstCol));
+    if (!(pieces(ForAI) & from) || (occupied() & to)) return false;
+
+    if (kings[S::INDEX] & from) {
+        // Damka: pole docelowe na jednej z przekątnych, bez pionków po drodze
+        for (int dir = DIR_UP_LEFT; dir <= DIR_DOWN_RIGHT; dir++) {
+            if (kingReach(src, dir, occupied()) & to) return true;
+        }
         return false;
     }
-    
+
+    return ((DIAGONALS.neighbour[src][S::FORWARD_LEFT] | DIAGONALS.neighbour[src][S::FORWARD_RIGHT]) & to) != 0;
+}
+
+template<bool ForAI>
+bool Board::canCapture(int sq, int dir) const {
+    // Przeciwnik na sąsiednim polu i puste pole za nim
+    return (DIAGONALS.neighbour[sq][dir] & pieces(!ForAI)) && (DIAGONALS.jump[sq][dir] & ~occupied());
+}
+
+template<bool ForAI>
+bool Board::canCaptureKing(int sq, int dir, int& enemySq, int& jumpSq) const {
+    Bitboard occ = occupied();
+
+    // Pierwszy pionek na przekątnej; własny lub brak - nie można zbić
+    Bitboard target = nearestOnRay(DIAGONALS.ray[sq][dir] & occ, dir);
+    if (!(target & pieces(!ForAI))) return false;
+
+    // Damka ląduje na polu bezpośrednio za przeciwnikiem
+    int targetSq = lowestSquare(target);
+    Bitboard jump = DIAGONALS.neighbour[targetSq][dir];
+    if (!jump || (jump & occ)) return false;
+
+    enemySq = targetSq;
+    jumpSq = lowestSquare(jump);
     return true;
 }
 
-bool Board::canCaptureKing(int row, int col, int deltaRow, int deltaCol, bool forAI, int& enemyRow, int& enemyCol, int& jumpRow, int& jumpCol) const {
-    for (int distance = 1; distance < SIZE - 1; distance++) {
-        int checkRow = row + deltaRow * distance;
-        int checkCol = col + deltaCol * distance;
-        
-        if (!isValidPosition(checkRow, checkCol)) return false;
-        
-        if (cells[checkRow][checkCol]) {
-            // Znaleziono pionek
-            if (cells[checkRow][checkCol]->getIsAI() != forAI) {
-                // To przeciwnik - sprawdź czy można go zbić
-                enemyRow = checkRow;
-                enemyCol = checkCol;
-                
-                // Sprawdź wszystkie możliwe pozycje lądowania za przeciwnikiem
-                for (int landDistance = 1; landDistance < SIZE; landDistance++) {
-                    jumpRow = enemyRow + deltaRow * landDistance;
-                    jumpCol = enemyCol + deltaCol * landDistance;
-                    
-                    if (!isValidPosition(jumpRow, jumpCol)) break;
-                    if (cells[jumpRow][jumpCol]) break;
-                    
-                    return true; // Można zbić
-                }
-            }
-            return false; // Własny pionek lub nie można zbić
-        }
+// Publiczne specjalizacje dla obu stron
+template void Board::generateMoves<true>(MoveList& moves) const;
+template void Board::generateMoves<false>(MoveList& moves) const;
+template bool Board::hasCaptures<true>() const;
+template bool Board::hasCaptures<false>() const;
+template bool Board::isLegalQuietMove<true>(const Move& move) const;
+template bool Board::isLegalQuietMove<false>(const Move& move) const;
+
+void Board::addPiece(int s, bool isKing, int sq) {
+    if (isKing) {
+        kings[s] |= squareBit(sq);
+    } else {
+        men[s] |= squareBit(sq);
     }
-    return false;
+    hashKey ^= pieceKey(s, isKing, sq);
+    pieceSquareScore += pieceSquare.values[s * 2 + (isKing ? 1 : 0)][sq];
 }
 
-bool Board::isValidMove(int srcRow, int srcCol, int dstRow, int dstCol, bool forAI) const {
-    // Sprawdź granice planszy
-    if (!isValidPosition(srcRow, srcCol) || !isValidPosition(dstRow, dstCol)) {
-        return false;
-    }
-    
-    // Sprawdź czy pole źródłowe ma pionek gracza
-    auto piece = cells[srcRow][srcCol];
-    if (!piece || piece->getIsAI() != forAI) {
-        return false;
+void Board::removePiece(int sq) {
+    Bitboard bit = squareBit(sq);
+    for (int s = 0; s < 2; s++) {
+        if (men[s] & bit) {
+            men[s] &= ~bit;
+            hashKey ^= pieceKey(s, false, sq);
+            pieceSquareScore -= pieceSquare.values[s * 2][sq];
+        }
+        if (kings[s] & bit) {
+            kings[s] &= ~bit;
+            hashKey ^= pieceKey(s, true, sq);
+            pieceSquareScore -= pieceSquare.values[s * 2 + 1][sq];
+        }
     }
-    
-    // Sprawdź czy pole docelowe jest puste
-    if (cells[dstRow][dstCol]) {
-        return false;
+}
+
+Bitboard Board::threatsIn(Bitboard region) const {
+    Bitboard empty = ~occupied();
+    Bitboard result = 0;
+
+    // Przeciwnik na sąsiednim polu i puste pole za nim, we wszystkich kierunkach
+    // (także do tyłu dla pionków, tak jak w dawnej ocenie)
+    for (int s = 0; s < 2; s++) {
+        Bitboard own = (men[s] | kings[s]) & region;
+        Bitboard enemy = men[1 - s] | kings[1 - s];
+        for (int dir = DIR_UP_LEFT; dir <= DIR_DOWN_RIGHT; dir++) {
+            Bitboard landing = shift(shift(own, dir) & enemy, dir) & empty;
+            int back = oppositeDirection(dir);
+            result |= shift(shift(landing, back), back);
+        }
     }
-    
-    // Sprawdź czy ruch jest po przekątnej o jedną pozycję
-    int deltaRow = abs(dstRow - srcRow);
-    int deltaCol = abs(dstCol - srcCol);
-    if (deltaRow != 1 || deltaCol != 1) {
-        return false;
+    return result;
+}
+
+void Board::updateThreats(Bitboard changed) {
+    // Możliwość bicia zależy od pola pionka i dwóch kolejnych pól na przekątnej,
+    // więc przeliczamy tylko pionki w odległości do dwóch pól od zmian
+    Bitboard region = changed;
+    for (int dir = DIR_UP_LEFT; dir <= DIR_DOWN_RIGHT; dir++) {
+        Bitboard near = shift(changed, dir);
+        region |= near | shift(near, dir);
     }
-    
-    // Sprawdź kierunek ruchu dla zwykłych pionków
-    if (!piece->getIsKing()) {
-        if (forAI && dstRow <= srcRow) {
-            return false; // AI musi się poruszać w dół
-        }
-        if (!forAI && dstRow >= srcRow) {
-            return false; // Gracz musi się poruszać w górę
-        }
+    threats = (threats & ~region) | threatsIn(region);
+}
+
+void Board::setAIToMove(bool forAI) {
+    if (aiToMove != forAI) {
+        aiToMove = forAI;
+        hashKey ^= zobrist.aiToMove;
     }
-    return true;
+}
 
+uint64_t Board::computeHash() const {
+    uint64_t key = aiToMove ? zobrist.aiToMove : 0;
+    for (int s = 0; s < 2; s++) {
+        key ^= maskKey(s, false, men[s]);
+        key ^= maskKey(s, true, kings[s]);
+    }
+    return key;
 }
 
 void Board::applyMove(const Move& move) {
-    if (!isValidPosition(move.srcRow, move.srcCol) || 
+    MoveUndo undo;
+    applyMove(move, undo);
+}
+
+void Board::applyMove(const Move& move, MoveUndo& undo) {
+    undo = MoveUndo();
+
+    if (!isValidPosition(move.srcRow, move.srcCol) ||
         !isValidPosition(move.dstRow, move.dstCol)) {
         return;
     }
-    
-    auto piece = cells[move.srcRow][move.srcCol];
-    if (!piece) return;
-    
+    if (!isDarkSquare(move.srcRow, move.srcCol) || !isDarkSquare(move.dstRow, move.dstCol)) {
+        return;
+    }
+
+    int src = squareIndex(move.srcRow, move.srcCol);
+    int dst = squareIndex(move.dstRow, move.dstCol);
+    Bitboard srcBit = squareBit(src);
+    Bitboard dstBit = squareBit(dst);
+    if (!(occupied() & srcBit)) return;
+
+    int s = (pieces(true) & srcBit) ? side(true) : side(false);
+    int enemy = 1 - s;
+    bool isKing = (kings[s] & srcBit) != 0;
+    undo.side = s;
+    undo.aiToMove = aiToMove;
+    undo.threats = threats;
+
+    // Zapamiętaj zbite pionki przeciwnika, zanim znikną z planszy
+    Bitboard captured = move.capturedMask;
+    undo.capturedMen = men[enemy] & captured;
+    undo.capturedKings = kings[enemy] & captured;
+
     // Przesuń pionek
-    cells[move.dstRow][move.dstCol] = piece;
-    cells[move.srcRow][move.srcCol] = nullptr;
-    
+    removePiece(src);
+    removePiece(dst);
+
     // Usuń WSZYSTKIE zbite pionki
-    for (const auto& capturedPos : move.capturedPositions) {
-        if (isValidPosition(capturedPos.first, capturedPos.second)) {
-            cells[capturedPos.first][capturedPos.second] = nullptr;
-        }
+    while (captured) {
+        removePiece(popLowestSquare(captured));
     }
-    
-    // Sprawdź promocję do damki na podstawie współrzędnych
-    //checkPromotion(move, piece);
+
+    // Promocja do damki po dojściu do ostatniego wiersza
+    undo.promoted = !isKing && (dstBit & PROMOTION_ROW[s]);
+    addPiece(s, isKing || undo.promoted, dst);
+    updateThreats(srcBit | dstBit | move.capturedMask);
+
+    // Teraz ruch ma przeciwnik
+    setAIToMove(s == side(false));
+
+    BOARD_CHECK(hashKey == computeHash());
+    BOARD_CHECK(evaluate() == computeEvaluation());
 }
 
-void Board::undoMove(const Move& move, const std::vector<std::shared_ptr<Piece>>& capturedPieces) {
-    // Przywróć pionek na początkową pozycję
-    auto piece = cells[move.dstRow][move.dstCol];
-    cells[move.srcRow][move.srcCol] = piece;
-    cells[move.dstRow][move.dstCol] = nullptr;
-    
+void Board::undoMove(const Move& move, const MoveUndo& undo) {
+    if (undo.side < 0) return;
+
+    int s = undo.side;
+    int enemy = 1 - s;
+    int src = squareIndex(move.srcRow, move.srcCol);
+    int dst = squareIndex(move.dstRow, move.dstCol);
+
+    // Przywróć pionek na początkową pozycję (promowany wraca jako zwykły pionek)
+    bool isKing = (kings[s] & squareBit(dst)) != 0;
+    removePiece(dst);
+    addPiece(s, isKing && !undo.promoted, src);
+
     // Przywróć zbite pionki
-    for (size_t i = 0; i < move.capturedPositions.size() && i < capturedPieces.size(); i++) {
-        const auto& pos = move.capturedPositions[i];
-        cells[pos.first][pos.second] = capturedPieces[i];
+    Bitboard captured = undo.capturedMen | undo.capturedKings;
+    while (captured) {
+        int sq = popLowestSquare(captured);
+        addPiece(enemy, (undo.capturedKings & squareBit(sq)) != 0, sq);
     }
+    threats = undo.threats;
+
+    setAIToMove(undo.aiToMove);
+
+    BOARD_CHECK(hashKey == computeHash());
+    BOARD_CHECK(evaluate() == computeEvaluation());
 }
 
 int Board::evaluate() const {
+    int threatScore = popCount(threats & pieces(true)) - popCount(threats & pieces(false));
+    return pieceSquareScore + 5 * threatScore;
+}
+
+int Board::computeEvaluation() const {
+    return computeSideEvaluation<true>() - computeSideEvaluation<false>();
+}
+
+template<bool ForAI>
+int Board::computeSideEvaluation() const {
     int score = 0;
 
-    for (int row = 0; row < SIZE; row++) {
-        for (int col = 0; col < SIZE; col++) {
-            if (cells[row][col]) {
-                int pieceValue = 10;
-                int kingValue = 50;
-                int value = cells[row][col]->getIsKing() ? kingValue : pieceValue;
-
-                // Premia za bliskość promocji (dla pionków)
-                if (!cells[row][col]->getIsKing()) {
-                    if (cells[row][col]->getIsAI()) {
-                        value += row; // im bliżej 7, tym lepiej dla AI
-                    } else {
-                        value += (7 - row); // im bliżej 0, tym lepiej dla gracza
-                    }
-                }
+    Bitboard own = pieces(ForAI);
+    while (own) {
+        int sq = popLowestSquare(own);
+        int row = squareRow(sq);
+        int col = squareCol(sq);
+        bool isKing = (kings[Side<ForAI>::INDEX] & squareBit(sq)) != 0;
 
-                // Premia za centrum planszy
-                int centerBonus = 3 - std::abs(3 - col);
-                value += centerBonus;
+        int pieceValue = 10;
+        int kingValue = 50;
+        int value = isKing ? kingValue : pieceValue;
 
-                // Kara za samotność (brak sąsiadów po bokach)
-                bool lonely = true;
-                for (int d = -1; d <= 1; d += 2) {
-                    int ncol = col + d;
-                    if (ncol >= 0 && ncol < SIZE && cells[row][ncol] && cells[row][ncol]->getIsAI() == cells[row][col]->getIsAI())
-                        lonely = false;
-                }
-                if (lonely) value -= 2;
-
-                // Premia za możliwość bicia
-                if (canCapture(row, col, 1, 1, cells[row][col]->getIsAI()) ||
-                    canCapture(row, col, 1, -1, cells[row][col]->getIsAI()) ||
-                    canCapture(row, col, -1, 1, cells[row][col]->getIsAI()) ||
-                    canCapture(row, col, -1, -1, cells[row][col]->getIsAI())) {
-                    value += 5;
-                }
+        // Premia za bliskość promocji (dla pionków): AI idzie do wiersza 7, gracz do 0
+        if (!isKing) {
+            value += ForAI ? row : 7 - row;
+        }
 
-                if (cells[row][col]->getIsAI()) {
-                    score += value;
-                } else {
-                    score -= value;
-                }
-            }
+        // Premia za centrum planszy
+        int centerBonus = 3 - std::abs(3 - col);
+        value += centerBonus;
+
+        // Kara za samotność (brak sąsiadów po bokach). Pola obok w tym samym
+        // wierszu są zawsze jasne i puste, więc kara dotyczy każdego pionka.
+        value -= 2;
+
+        // Premia za możliwość bicia
+        if (canCapture<ForAI>(sq, DIR_DOWN_RIGHT) ||
+            canCapture<ForAI>(sq, DIR_DOWN_LEFT) ||
+            canCapture<ForAI>(sq, DIR_UP_RIGHT) ||
+            canCapture<ForAI>(sq, DIR_UP_LEFT)) {
+            value += 5;
         }
+
+        score += value;
     }
 
     return score;
@@ -330,8 +477,9 @@ void Board::printBoard() const {
     for (int i = 0; i < SIZE; i++) {
         std::cout << i << " ";
         for (int j = 0; j < SIZE; j++) {
-            if (cells[i][j]) {
-                std::cout << cells[i][j]->getSymbol() << " ";
+            auto piece = getPiece(i, j);
+            if (piece) {
+                std::cout << piece->getSymbol() << " ";
             } else {
                 std::cout << ((i + j) % 2 == 0 ? "□ " : "■ ");
             }
@@ -341,156 +489,105 @@ void Board::printBoard() const {
 }
 
 std::shared_ptr<Piece> Board::getPiece(int row, int col) const {
-    if (isValidPosition(row, col)) {
-        return cells[row][col];
+    if (!isValidPosition(row, col) || !isDarkSquare(row, col)) {
+        return nullptr;
+    }
+
+    Bitboard bit = squareBit(squareIndex(row, col));
+    for (int s = 0; s < 2; s++) {
+        if ((men[s] | kings[s]) & bit) {
+            return std::make_shared<Piece>(s == side(true), (kings[s] & bit) != 0);
+        }
     }
     return nullptr;
 }
 
+void Board::setPiece(int row, int col, std::shared_ptr<Piece> piece) {
+    if (!isValidPosition(row, col) || !isDarkSquare(row, col)) {
+        return;
+    }
+
+    int sq = squareIndex(row, col);
+    removePiece(sq);
+    if (piece) {
+        addPiece(side(piece->getIsAI()), piece->getIsKing(), sq);
+    }
+    updateThreats(squareBit(sq));
+
+    BOARD_CHECK(hashKey == computeHash());
+}
+
 bool Board::isValidPosition(int row, int col) const {
     return row >= 0 && row < SIZE && col >= 0 && col < SIZE;
 }
 
 bool Board::hasValidMoves(bool forAI) const {
-    return !getValidMoves(forAI).empty();
+    MoveList moves;
+    generateMoves(forAI, moves);
+    return !moves.empty();
 }
 
-int Board::countPieces(bool forAI) const {
-    int count = 0;
-    for (int row = 0; row < SIZE; row++) {
-        for (int col = 0; col < SIZE; col++) {
-            if (cells[row][col] && cells[row][col]->getIsAI() == forAI) {
-                count++;
-            }
-        }
+const MoveList& LegalMoveCache::get(const Board& board, bool forAI) {
+    Entry& entry = entries[forAI ? 1 : 0];
+    if (!entry.valid ||
+        entry.men[0] != board.getMen(false) || entry.men[1] != board.getMen(true) ||
+        entry.kings[0] != board.getKings(false) || entry.kings[1] != board.getKings(true)) {
+        board.generateMoves(forAI, entry.moves);
+        entry.men[0] = board.getMen(false);
+        entry.men[1] = board.getMen(true);
+        entry.kings[0] = board.getKings(false);
+        entry.kings[1] = board.getKings(true);
+        entry.valid = true;
     }
-    return count;
+    return entry.moves;
 }
 
-std::vector<Move> Board::getMultiCaptureMoves(int row, int col, bool forAI, Move currentMove) const {
-    std::vector<Move> allCaptures;
-    auto piece = cells[row][col];
+int Board::countPieces(bool forAI) const {
+    return popCount(pieces(forAI));
+}
 
-    if (!piece) return allCaptures;
+template<bool ForAI>
+void Board::getMultiCaptureMoves(int sq, bool isKing, Bitboard baseOccupied,
+                                 Move& path, MoveList& moves) const {
+    // Zbite pionki (maska path.capturedMask) są zdejmowane z planszy na czas dalszych bić
+    Bitboard empty = ~(baseOccupied & ~path.capturedMask);
+    Bitboard enemy = pieces(!ForAI) & ~path.capturedMask;
 
-    std::vector<std::pair<int, int>> directions;
-    if (piece->getIsKing()) {
-        directions = {{-1, -1}, {-1, 1}, {1, -1}, {1, 1}};
-    } else {
-        directions = forAI ? std::vector<std::pair<int, int>>{{1, -1}, {1, 1}} : std::vector<std::pair<int, int>>{{-1, -1}, {-1, 1}};
-    }
+    // Zwykły pionek bije tylko do przodu
+    int firstDir = isKing ? DIR_UP_LEFT : Side<ForAI>::FORWARD_LEFT;
+    int lastDir = isKing ? DIR_DOWN_RIGHT : Side<ForAI>::FORWARD_RIGHT;
 
     bool hasCaptures = false;
 
-    for (const auto& dir : directions) {
-        if (piece->getIsKing()) {
-            int step = 1;
-            while (true) {
-                int enemyRow = row + step * dir.first;
-                int enemyCol = col + step * dir.second;
-                int jumpRow = row + (step + 1) * dir.first;
-                int jumpCol = col + (step + 1) * dir.second;
-
-                if (!isValidPosition(enemyRow, enemyCol) || !isValidPosition(jumpRow, jumpCol)) break;
-                if (!cells[enemyRow][enemyCol]) { 
-                    step++; 
-                    continue; 
-                }
-
-                if (canCaptureKing(row, col, dir.first, dir.second, forAI, enemyRow, enemyCol, jumpRow, jumpCol)) {
-                    bool alreadyCaptured = false;
-                    for (const auto& capturedPos : currentMove.capturedPositions) {
-                        if (capturedPos.first == enemyRow && capturedPos.second == enemyCol) {
-                            alreadyCaptured = true;
-                            break;
-                        }
-                    }
-
-                    if (!alreadyCaptured) {
-                        hasCaptures = true;
-
-                        Move newMove = currentMove;
-                        if (newMove.srcRow == -1) {
-                            newMove.srcRow = row;
-                            newMove.srcCol = col;
-                        }
-                        newMove.dstRow = jumpRow;
-                        newMove.dstCol = jumpCol;
-                        newMove.capturedPositions.push_back({enemyRow, enemyCol});
-
-                        Board tempBoard = *this;
-                        tempBoard.cells[row][col] = nullptr;
-                        tempBoard.cells[jumpRow][jumpCol] = piece;
-                        tempBoard.cells[enemyRow][enemyCol] = nullptr;
-
-                        auto furtherCaptures = tempBoard.getMultiCaptureMoves(jumpRow, jumpCol, forAI, newMove);
-                        
-                        if (furtherCaptures.empty()) {
-                            allCaptures.push_back(newMove);
-                        } else {
-                            allCaptures.insert(allCaptures.end(), furtherCaptures.begin(), furtherCaptures.end());
-                        }
-                    }
-                }
-                break;
-            }
-        } else {
-            if (canCapture(row, col, dir.first, dir.second, forAI)) {
-                int enemyRow = row + dir.first;
-                int enemyCol = col + dir.second;
-                int jumpRow = row + 2 * dir.first;
-                int jumpCol = col + 2 * dir.second;
-
-                bool alreadyCaptured = false;
-                for (const auto& capturedPos : currentMove.capturedPositions) {
-                    if (capturedPos.first == enemyRow && capturedPos.second == enemyCol) {
-                        alreadyCaptured = true;
-                        break;
-                    }
-                }
-
-                if (!alreadyCaptured) {
-                    hasCaptures = true;
-
-                    Move newMove = currentMove;
-                    if (newMove.srcRow == -1) {
-                        newMove.srcRow = row;
-                        newMove.srcCol = col;
-                    }
-                    newMove.dstRow = jumpRow;
-                    newMove.dstCol = jumpCol;
-                    newMove.capturedPositions.push_back({enemyRow, enemyCol});
-
-                    Board tempBoard = *this;
-                    tempBoard.cells[row][col] = nullptr;
-                    tempBoard.cells[jumpRow][jumpCol] = piece;
-                    tempBoard.cells[enemyRow][enemyCol] = nullptr;
-
-                    auto furtherCaptures = tempBoard.getMultiCaptureMoves(jumpRow, jumpCol, forAI, newMove);
-
-                    if (furtherCaptures.empty()) {
-                        allCaptures.push_back(newMove);
-                    } else {
-                        allCaptures.insert(allCaptures.end(), furtherCaptures.begin(), furtherCaptures.end());
-                    }
-                }
-            }
-        }
+    for (int dir = firstDir; dir <= lastDir; dir++) {
+        // Damka przechodzi po pustych polach do pierwszego pionka na przekątnej
+        Bitboard target = isKing ? nearestOnRay(DIAGONALS.ray[sq][dir] & ~empty, dir)
+                                 : DIAGONALS.neighbour[sq][dir];
+
+        // Przeciwnik i puste pole bezpośrednio za nim
+        target &= enemy;
+        if (!target) continue;
+        Bitboard landing = DIAGONALS.neighbour[lowestSquare(target)][dir] & empty;
+        if (!landing) continue;
+
+        hasCaptures = true;
+
+        int8_t prevRow = path.dstRow;
+        int8_t prevCol = path.dstCol;
+        int jumpSq = lowestSquare(landing);
+        path.dstRow = squareRow(jumpSq);
+        path.dstCol = squareCol(jumpSq);
+        path.addCapture(lowestSquare(target));
+
+        getMultiCaptureMoves<ForAI>(jumpSq, isKing, baseOccupied, path, moves);
+
+        // Przywróć ścieżkę przed sprawdzeniem kolejnego kierunku
+        path.captureCount--;
+        path.capturedMask &= ~target;
+        path.dstRow = prevRow;
+        path.dstCol = prevCol;
     }
 
-    if (currentMove.srcRow == -1 && !hasCaptures) return allCaptures;
-    if (currentMove.srcRow != -1 && !hasCaptures) allCaptures.push_back(currentMove);
-
-    return allCaptures;
-}
-/*
-void Board::checkPromotion(const Move& move, std::shared_ptr<Piece> piece) {
-    if (!piece->getIsKing()) {
-        if (piece->getIsAI() && move.dstRow == 7) {
-            piece->promote();
-        }
-        else if (!(piece->getIsAI()) && move.dstRow == 0) {
-            piece->promote();
-        }
-    }
-}*/
\ No newline at end of file
+    // Koniec sekwencji bić - zapisz ruch
+    if (path.isCapture() && !hasCaptures) moves.push(path);
+}
\ No newline at end of file
@@ -3,58 +3,184 @@
 
 #include <vector>
 #include <memory>
+#include <cstdint>
+#include <cassert>
 #include "piece.h"
+#include "bitboard.h"
 
+// Kontrola stanu przyrostowego pełnym przeliczeniem po każdej zmianie planszy.
+// Kosztuje więcej niż sam ruch, więc działa tylko w buildzie z -DBOARD_CHECKS (make debug),
+// a nie w każdym buildzie bez NDEBUG
+#ifdef BOARD_CHECKS
+#define BOARD_CHECK(condition) assert(condition)
+#else
+#define BOARD_CHECK(condition) ((void)0)
+#endif
+
+// Zwarty ruch bez alokacji: pola zbitych pionków są trzymane w tablicy w miejscu
 struct Move {
-    int srcRow, srcCol;
-    int dstRow, dstCol;
-    std::vector<std::pair<int, int>> capturedPositions; // Pozycje zbitych pionków
-    
-    Move() : srcRow(-1), srcCol(-1), dstRow(-1), dstCol(-1) {}
-    Move(int sr, int sc, int dr, int dc) : srcRow(sr), srcCol(sc), dstRow(dr), dstCol(dc) {}
+    static const int MAX_CAPTURES = 12; // przeciwnik ma najwyżej 12 pionków
+
+    int8_t srcRow, srcCol;
+    int8_t dstRow, dstCol;
+    uint8_t captureCount;                 // Liczba zbitych pionków
+    uint8_t captures[MAX_CAPTURES];       // Indeksy zbitych pól w kolejności bicia
+    Bitboard capturedMask;                // Te same pola jako maska bitowa
+
+    Move() : srcRow(-1), srcCol(-1), dstRow(-1), dstCol(-1), captureCount(0), capturedMask(0) {}
+    Move(int sr, int sc, int dr, int dc)
+        : srcRow(sr), srcCol(sc), dstRow(dr), dstCol(dc), captureCount(0), capturedMask(0) {}
+
+    bool isCapture() const { return captureCount != 0; }
+    void addCapture(int sq) {
+        captures[captureCount++] = static_cast<uint8_t>(sq);
+        capturedMask |= squareBit(sq);
+    }
+    int capturedRow(int i) const { return squareRow(captures[i]); }
+    int capturedCol(int i) const { return squareCol(captures[i]); }
+};
+
+// Lista ruchów o stałej pojemności, trzymana na stosie wywołującego
+class MoveList {
+public:
+    static const int CAPACITY = 256;
+
+    MoveList() : count(0) {}
+
+    void push(const Move& move) {
+        assert(count < CAPACITY);
+        if (count < CAPACITY) slots[count++].move = move;
+    }
+    void clear() { count = 0; }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    Move& operator[](int i) { return slots[i].move; }
+    const Move& operator[](int i) const { return slots[i].move; }
+    Move* begin() { return &slots[0].move; }
+    Move* end() { return &slots[0].move + count; }
+    const Move* begin() const { return &slots[0].move; }
+    const Move* end() const { return &slots[0].move + count; }
+
+private:
+    // Pola listy nie są inicjalizowane - konstruowanie wszystkich ruchów
+    // przy każdym węźle przeszukiwania kosztowałoby więcej niż samo generowanie
+    union Slot {
+        Move move;
+        Slot() {}
+    };
+
+    Slot slots[CAPACITY];
+    int count;
+};
+
+// Dane potrzebne do cofnięcia ruchu w undoMove
+struct MoveUndo {
+    int side;               // strona, która wykonała ruch (-1 = ruch nie został wykonany)
+    bool promoted;          // czy pionek awansował do damki
+    bool aiToMove;          // strona na ruchu przed wykonaniem ruchu
+    Bitboard capturedMen;   // zbite pionki przeciwnika
+    Bitboard capturedKings; // zbite damki przeciwnika
+
+    Bitboard threats;       // maska zagrożeń sprzed ruchu
+
+    MoveUndo() : side(-1), promoted(false), aiToMove(false), capturedMen(0), capturedKings(0), threats(0) {}
 };
 
 class Board {
 public:
     static const int SIZE = 8;
-    std::shared_ptr<Piece> cells[SIZE][SIZE]; // Plansza 8x8 z pionkami
 
     Board();
     ~Board() = default;
 
     void init();
     std::vector<Move> getValidMoves(bool forAI) const;
-
-    
+    // Strona jako parametr szablonu: wersje bool tylko wybierają specjalizację
+    template<bool ForAI> void generateMoves(MoveList& moves) const;
+    void generateMoves(bool forAI, MoveList& moves) const {
+        forAI ? generateMoves<true>(moves) : generateMoves<false>(moves);
+    }
 
     void applyMove(const Move& move);
-    void undoMove(const Move& move, const std::vector<std::shared_ptr<Piece>>& capturedPieces);
+    void applyMove(const Move& move, MoveUndo& undo);
+    void undoMove(const Move& move, const MoveUndo& undo);
+    // Ocena utrzymywana przyrostowo: sumy materiału i tablic pól aktualizowane
+    // przy każdej zmianie pionka oraz maska pionków z możliwością bicia
     int evaluate() const;
+    int computeEvaluation() const; // Pełne przeliczenie - do kontroli BOARD_CHECK
     void printBoard() const;
 
-    //void checkPromotion(const Move& move, std::shared_ptr<Piece> piece);
-    
     // Dodatkowe metody dla GUI
     std::shared_ptr<Piece> getPiece(int row, int col) const;
+    void setPiece(int row, int col, std::shared_ptr<Piece> piece);
     bool isValidPosition(int row, int col) const;
     bool hasValidMoves(bool forAI) const;
+    // Czy bicie jest obowiązkowe
+    template<bool ForAI> bool hasCaptures() const;
+    bool hasCaptures(bool forAI) const { return forAI ? hasCaptures<true>() : hasCaptures<false>(); }
+    // Czy ruch bez bicia jest legalny; zakłada, że bicie nie jest obowiązkowe
+    template<bool ForAI> bool isLegalQuietMove(const Move& move) const;
+    bool isLegalQuietMove(const Move& move, bool forAI) const {
+        return forAI ? isLegalQuietMove<true>(move) : isLegalQuietMove<false>(move);
+    }
     int countPieces(bool forAI) const;
+    Bitboard getMen(bool forAI) const { return men[side(forAI)]; }
+    Bitboard getKings(bool forAI) const { return kings[side(forAI)]; }
+
+    // Hash Zobrista (rodzaj pionka, kolor, pole, strona na ruchu), aktualizowany przyrostowo
+    uint64_t getHash() const { return hashKey; }
+    uint64_t computeHash() const; // Pełne przeliczenie - do kontroli BOARD_CHECK
+    bool isAIToMove() const { return aiToMove; }
+    void setAIToMove(bool forAI);
 
 private:
-    
-    
-    // Funkcje pomocnicze
-    std::vector<Move> getPieceMovesAndCaptures(int row, int col, bool forAI) const;
-    std::vector<Move> getCaptureMoves(int row, int col, bool forAI) const;
-    std::vector<Move> getSimpleMoves(int row, int col, bool forAI) const;
+    // Bitboardy ciemnych pól, indeksowane stroną: [0] = gracz, [1] = AI
+    Bitboard men[2];
+    Bitboard kings[2];
+    uint64_t hashKey;
+    bool aiToMove;
+    int pieceSquareScore; // materiał, awans, centrum i kara za samotność; dodatnie dla AI
+    Bitboard threats;     // pionki obu stron, które mogą bić na sąsiednim polu
+
+    static int side(bool forAI) { return forAI ? 1 : 0; }
+    Bitboard pieces(bool forAI) const { return men[side(forAI)] | kings[side(forAI)]; }
+    Bitboard occupied() const { return men[0] | men[1] | kings[0] | kings[1]; }
+    void addPiece(int s, bool isKing, int sq);
+    void removePiece(int sq);
+    Bitboard threatsIn(Bitboard region) const;
+    void updateThreats(Bitboard changed);
+
+    // Funkcje pomocnicze, specjalizowane stroną (Side<ForAI>)
+    template<bool ForAI> Bitboard getCapturers() const;
+    template<bool ForAI> void getCaptureMoves(int sq, MoveList& moves) const;
+    template<bool ForAI> void getSimpleMoves(int sq, MoveList& moves) const;
 
-    std::vector<Move> getMultiCaptureMoves(int row, int col, bool forAI, Move currentMove = Move()) const;
+    template<bool ForAI> void getMultiCaptureMoves(int sq, bool isKing, Bitboard baseOccupied,
+                                                   Move& path, MoveList& moves) const;
 
+    template<bool ForAI> bool canCapture(int sq, int dir) const;
+    template<bool ForAI> bool canCaptureKing(int sq, int dir, int& enemySq, int& jumpSq) const;
+    template<bool ForAI> int computeSideEvaluation() const;
+};
 
-    bool canCapture(int row, int col, int deltaRow, int deltaCol, bool forAI) const;
-    bool isValidMove(int srcRow, int srcCol, int dstRow, int dstCol, bool forAI) const;
+// Legalne ruchy obu stron dla GUI i pętli gry, które w każdej klatce pytają o tę samą
+// pozycję. Lista jest ważna, dopóki maski planszy się nie zmienią - porównanie masek
+// zastępuje unieważnianie, więc applyMove/undoMove nic nie kosztuje. Pamięć należy do
+// właściciela obiektu, a nie do planszy, więc kopie Board jej nie przenoszą.
+class LegalMoveCache {
+public:
+    const MoveList& get(const Board& board, bool forAI);
+    bool hasMoves(const Board& board, bool forAI) { return !get(board, forAI).empty(); }
 
-    bool canCaptureKing(int row, int col, int deltaRow, int deltaCol, bool forAI, int& enemyRow, int& enemyCol, int& jumpRow, int& jumpCol) const;
+private:
+    struct Entry {
+        bool valid = false;
+        Bitboard men[2];   // [0] = gracz, [1] = AI, jak w Board
+        Bitboard kings[2];
+        MoveList moves;
+    };
+    Entry entries[2];
 };
 
 #endif // BOARD_H
\ No newline at end of file
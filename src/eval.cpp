@@ -0,0 +1,422 @@
+#include "eval.h"
+#include <thread>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define EVAL_X86 1
+#endif
+
+// Bity numeru wiersza: awans pionka AI to suma 2^k * popcount(pionki & ROW_BIT[k]),
+// a pionka gracza (7 - wiersz) to ta sama suma po zanegowanych maskach
+static const Bitboard ROW_BIT[3] = {0xF0F0F0F0u, 0xFF00FF00u, 0xFFFF0000u};
+
+// Bity wagi kolumny (3 - |3 - kolumna|) + 1, od 0 w kolumnie 7 do 4 w kolumnie 3
+static const Bitboard CENTRE_BIT[3] = {0xF0F0F0F0u, 0x65656565u, 0x02020202u};
+
+EvalPosition::EvalPosition() : men{0, 0}, kings{0, 0} {}
+
+EvalPosition::EvalPosition(const Board& board) {
+    for (int s = 0; s < 2; s++) {
+        men[s] = board.getMen(s == 1);
+        kings[s] = board.getKings(s == 1);
+    }
+}
+
+// Pionki, które mogą bić na sąsiednim polu w którymkolwiek kierunku
+static Bitboard threatMask(Bitboard own, Bitboard enemy, Bitboard empty) {
+    Bitboard result = 0;
+    for (int dir = DIR_UP_LEFT; dir <= DIR_DOWN_RIGHT; dir++) {
+        Bitboard landing = shift(shift(own, dir) & enemy, dir) & empty;
+        int back = DIR_DOWN_RIGHT - dir;
+        result |= shift(shift(landing, back), back);
+    }
+    return result;
+}
+
+int evaluatePosition(const EvalPosition& position) {
+    Bitboard empty = ~(position.men[0] | position.men[1] | position.kings[0] | position.kings[1]);
+    int score = 0;
+
+    for (int s = 0; s < 2; s++) {
+        Bitboard men = position.men[s];
+        Bitboard own = men | position.kings[s];
+        Bitboard enemy = position.men[1 - s] | position.kings[1 - s];
+
+        // Materiał, stała kara za samotność i przesunięcie wagi kolumny o 1
+        int value = 10 * popCount(men) + 50 * popCount(position.kings[s]) - 3 * popCount(own);
+        for (int k = 0; k < 3; k++) {
+            value += popCount(men & (s == 1 ? ROW_BIT[k] : ~ROW_BIT[k])) << k;
+            value += popCount(own & CENTRE_BIT[k]) << k;
+        }
+        value += 5 * popCount(threatMask(own, enemy, empty));
+
+        score += s == 1 ? value : -value;
+    }
+
+    return score;
+}
+
+static void evaluateBatchScalar(const EvalPosition* positions, int* scores, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        scores[i] = evaluatePosition(positions[i]);
+    }
+}
+
+// Wskaźniki na początek fragmentu bufora struktury tablic
+struct MaskArrays {
+    const Bitboard* men[2];
+    const Bitboard* kings[2];
+
+    EvalPosition at(size_t index) const {
+        EvalPosition position;
+        for (int s = 0; s < 2; s++) {
+            position.men[s] = men[s][index];
+            position.kings[s] = kings[s][index];
+        }
+        return position;
+    }
+};
+
+static void evaluateArraysScalar(const MaskArrays& arrays, int* scores, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        scores[i] = evaluatePosition(arrays.at(i));
+    }
+}
+
+#ifdef EVAL_X86
+
+// ---- SSE4.1: 4 pozycje w 32-bitowych liczbach rejestru ----
+
+__attribute__((target("sse4.1")))
+static inline __m128i masked4(__m128i b, Bitboard mask) {
+    return _mm_and_si128(b, _mm_set1_epi32(static_cast<int>(mask)));
+}
+
+__attribute__((target("sse4.1")))
+static inline __m128i shift4(__m128i b, int dir) {
+    // Te same przesunięcia co w bitboard.h
+    switch (dir) {
+        case DIR_UP_LEFT:
+            return _mm_or_si128(_mm_srli_epi32(masked4(b, EVEN_ROWS & ~TOP_ROW), 4),
+                                _mm_srli_epi32(masked4(b, ODD_ROWS & ~LEFT_EDGE), 5));
+        case DIR_UP_RIGHT:
+            return _mm_or_si128(_mm_srli_epi32(masked4(b, EVEN_ROWS & ~TOP_ROW & ~RIGHT_EDGE), 3),
+                                _mm_srli_epi32(masked4(b, ODD_ROWS), 4));
+        case DIR_DOWN_LEFT:
+            return _mm_or_si128(_mm_slli_epi32(masked4(b, EVEN_ROWS), 4),
+                                _mm_slli_epi32(masked4(b, ODD_ROWS & ~LEFT_EDGE & ~BOTTOM_ROW), 3));
+        default:
+            return _mm_or_si128(_mm_slli_epi32(masked4(b, EVEN_ROWS & ~RIGHT_EDGE), 5),
+                                _mm_slli_epi32(masked4(b, ODD_ROWS & ~BOTTOM_ROW), 4));
+    }
+}
+
+__attribute__((target("sse4.1")))
+static inline __m128i popCount4(__m128i v) {
+    // Liczba bitów każdego półbajtu z tablicy, potem suma czterech bajtów liczby
+    const __m128i lut = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m128i low = _mm_set1_epi8(0x0F);
+    __m128i bytes = _mm_add_epi8(_mm_shuffle_epi8(lut, _mm_and_si128(v, low)),
+                                 _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(v, 4), low)));
+    __m128i words = _mm_maddubs_epi16(bytes, _mm_set1_epi8(1));
+    return _mm_madd_epi16(words, _mm_set1_epi16(1));
+}
+
+__attribute__((target("sse4.1")))
+static __m128i scoreLanes4(const __m128i men[2], const __m128i kings[2]) {
+    __m128i own[2] = {_mm_or_si128(men[0], kings[0]), _mm_or_si128(men[1], kings[1])};
+    __m128i empty = _mm_xor_si128(_mm_or_si128(own[0], own[1]), _mm_set1_epi32(-1));
+    __m128i score = _mm_setzero_si128();
+
+    for (int s = 0; s < 2; s++) {
+        __m128i threats = _mm_setzero_si128();
+        for (int dir = DIR_UP_LEFT; dir <= DIR_DOWN_RIGHT; dir++) {
+            int back = DIR_DOWN_RIGHT - dir;
+            __m128i landing = _mm_and_si128(shift4(_mm_and_si128(shift4(own[s], dir), own[1 - s]), dir), empty);
+            threats = _mm_or_si128(threats, shift4(shift4(landing, back), back));
+        }
+
+        __m128i value = _mm_mullo_epi32(popCount4(men[s]), _mm_set1_epi32(10));
+        value = _mm_add_epi32(value, _mm_mullo_epi32(popCount4(kings[s]), _mm_set1_epi32(50)));
+        value = _mm_sub_epi32(value, _mm_mullo_epi32(popCount4(own[s]), _mm_set1_epi32(3)));
+        value = _mm_add_epi32(value, _mm_mullo_epi32(popCount4(threats), _mm_set1_epi32(5)));
+        for (int k = 0; k < 3; k++) {
+            Bitboard rows = s == 1 ? ROW_BIT[k] : ~ROW_BIT[k];
+            __m128i bits = _mm_add_epi32(popCount4(masked4(men[s], rows)),
+                                         popCount4(masked4(own[s], CENTRE_BIT[k])));
+            value = _mm_add_epi32(value, _mm_sll_epi32(bits, _mm_cvtsi32_si128(k)));
+        }
+
+        score = s == 1 ? _mm_add_epi32(score, value) : _mm_sub_epi32(score, value);
+    }
+
+    return score;
+}
+
+__attribute__((target("sse4.1")))
+static void evaluateBatchSse(const EvalPosition* positions, int* scores, size_t count) {
+    static_assert(sizeof(EvalPosition) == 4 * sizeof(Bitboard), "EvalPosition must be 4 packed masks");
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        // Transpozycja 4x4: rejestr na pozycję -> rejestr na maskę
+        const __m128i* data = reinterpret_cast<const __m128i*>(positions + i);
+        __m128i r0 = _mm_loadu_si128(data), r1 = _mm_loadu_si128(data + 1);
+        __m128i r2 = _mm_loadu_si128(data + 2), r3 = _mm_loadu_si128(data + 3);
+        __m128i t0 = _mm_unpacklo_epi32(r0, r1), t1 = _mm_unpackhi_epi32(r0, r1);
+        __m128i t2 = _mm_unpacklo_epi32(r2, r3), t3 = _mm_unpackhi_epi32(r2, r3);
+
+        __m128i men[2] = {_mm_unpacklo_epi64(t0, t2), _mm_unpackhi_epi64(t0, t2)};
+        __m128i kings[2] = {_mm_unpacklo_epi64(t1, t3), _mm_unpackhi_epi64(t1, t3)};
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(scores + i), scoreLanes4(men, kings));
+    }
+    evaluateBatchScalar(positions + i, scores + i, count - i);
+}
+
+__attribute__((target("sse4.1")))
+static void evaluateArraysSse(const MaskArrays& arrays, int* scores, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i men[2], kings[2];
+        for (int s = 0; s < 2; s++) {
+            men[s] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(arrays.men[s] + i));
+            kings[s] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(arrays.kings[s] + i));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(scores + i), scoreLanes4(men, kings));
+    }
+    for (; i < count; i++) {
+        scores[i] = evaluatePosition(arrays.at(i));
+    }
+}
+
+// ---- AVX2: 8 pozycji ----
+
+__attribute__((target("avx2")))
+static inline __m256i masked8(__m256i b, Bitboard mask) {
+    return _mm256_and_si256(b, _mm256_set1_epi32(static_cast<int>(mask)));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i shift8(__m256i b, int dir) {
+    switch (dir) {
+        case DIR_UP_LEFT:
+            return _mm256_or_si256(_mm256_srli_epi32(masked8(b, EVEN_ROWS & ~TOP_ROW), 4),
+                                   _mm256_srli_epi32(masked8(b, ODD_ROWS & ~LEFT_EDGE), 5));
+        case DIR_UP_RIGHT:
+            return _mm256_or_si256(_mm256_srli_epi32(masked8(b, EVEN_ROWS & ~TOP_ROW & ~RIGHT_EDGE), 3),
+                                   _mm256_srli_epi32(masked8(b, ODD_ROWS), 4));
+        case DIR_DOWN_LEFT:
+            return _mm256_or_si256(_mm256_slli_epi32(masked8(b, EVEN_ROWS), 4),
+                                   _mm256_slli_epi32(masked8(b, ODD_ROWS & ~LEFT_EDGE & ~BOTTOM_ROW), 3));
+        default:
+            return _mm256_or_si256(_mm256_slli_epi32(masked8(b, EVEN_ROWS & ~RIGHT_EDGE), 5),
+                                   _mm256_slli_epi32(masked8(b, ODD_ROWS & ~BOTTOM_ROW), 4));
+    }
+}
+
+__attribute__((target("avx2")))
+static inline __m256i popCount8(__m256i v) {
+    const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lut, _mm256_and_si256(v, low)),
+                                    _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), low)));
+    __m256i words = _mm256_maddubs_epi16(bytes, _mm256_set1_epi8(1));
+    return _mm256_madd_epi16(words, _mm256_set1_epi16(1));
+}
+
+__attribute__((target("avx2")))
+static __m256i scoreLanes8(const __m256i men[2], const __m256i kings[2]) {
+    __m256i own[2] = {_mm256_or_si256(men[0], kings[0]), _mm256_or_si256(men[1], kings[1])};
+    __m256i empty = _mm256_xor_si256(_mm256_or_si256(own[0], own[1]), _mm256_set1_epi32(-1));
+    __m256i score = _mm256_setzero_si256();
+
+    for (int s = 0; s < 2; s++) {
+        __m256i threats = _mm256_setzero_si256();
+        for (int dir = DIR_UP_LEFT; dir <= DIR_DOWN_RIGHT; dir++) {
+            int back = DIR_DOWN_RIGHT - dir;
+            __m256i landing = _mm256_and_si256(shift8(_mm256_and_si256(shift8(own[s], dir), own[1 - s]), dir), empty);
+            threats = _mm256_or_si256(threats, shift8(shift8(landing, back), back));
+        }
+
+        __m256i value = _mm256_mullo_epi32(popCount8(men[s]), _mm256_set1_epi32(10));
+        value = _mm256_add_epi32(value, _mm256_mullo_epi32(popCount8(kings[s]), _mm256_set1_epi32(50)));
+        value = _mm256_sub_epi32(value, _mm256_mullo_epi32(popCount8(own[s]), _mm256_set1_epi32(3)));
+        value = _mm256_add_epi32(value, _mm256_mullo_epi32(popCount8(threats), _mm256_set1_epi32(5)));
+        for (int k = 0; k < 3; k++) {
+            Bitboard rows = s == 1 ? ROW_BIT[k] : ~ROW_BIT[k];
+            __m256i bits = _mm256_add_epi32(popCount8(masked8(men[s], rows)),
+                                            popCount8(masked8(own[s], CENTRE_BIT[k])));
+            value = _mm256_add_epi32(value, _mm256_sll_epi32(bits, _mm_cvtsi32_si128(k)));
+        }
+
+        score = s == 1 ? _mm256_add_epi32(score, value) : _mm256_sub_epi32(score, value);
+    }
+
+    return score;
+}
+
+__attribute__((target("avx2")))
+static void evaluateBatchAvx2(const EvalPosition* positions, int* scores, size_t count) {
+    // Transpozycja w połówkach rejestru daje kolejność 0 2 4 6 1 3 5 7 - przywraca ją permutacja
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i* data = reinterpret_cast<const __m256i*>(positions + i);
+        __m256i r0 = _mm256_loadu_si256(data), r1 = _mm256_loadu_si256(data + 1);
+        __m256i r2 = _mm256_loadu_si256(data + 2), r3 = _mm256_loadu_si256(data + 3);
+        __m256i t0 = _mm256_unpacklo_epi32(r0, r1), t1 = _mm256_unpackhi_epi32(r0, r1);
+        __m256i t2 = _mm256_unpacklo_epi32(r2, r3), t3 = _mm256_unpackhi_epi32(r2, r3);
+
+        __m256i men[2] = {_mm256_unpacklo_epi64(t0, t2), _mm256_unpackhi_epi64(t0, t2)};
+        __m256i kings[2] = {_mm256_unpacklo_epi64(t1, t3), _mm256_unpackhi_epi64(t1, t3)};
+        __m256i result = _mm256_permutevar8x32_epi32(scoreLanes8(men, kings), order);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(scores + i), result);
+    }
+    evaluateBatchScalar(positions + i, scores + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void evaluateArraysAvx2(const MaskArrays& arrays, int* scores, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i men[2], kings[2];
+        for (int s = 0; s < 2; s++) {
+            men[s] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(arrays.men[s] + i));
+            kings[s] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(arrays.kings[s] + i));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(scores + i), scoreLanes8(men, kings));
+    }
+    for (; i < count; i++) {
+        scores[i] = evaluatePosition(arrays.at(i));
+    }
+}
+
+#endif // EVAL_X86
+
+bool isEvalKernelSupported(EvalKernel kernel) {
+    switch (kernel) {
+#ifdef EVAL_X86
+        case EvalKernel::AVX2: return __builtin_cpu_supports("avx2");
+        case EvalKernel::SSE: return __builtin_cpu_supports("sse4.1");
+#endif
+        case EvalKernel::SCALAR: return true;
+        default: return false;
+    }
+}
+
+EvalKernel bestEvalKernel() {
+    static const EvalKernel best = isEvalKernelSupported(EvalKernel::AVX2) ? EvalKernel::AVX2 :
+                                   isEvalKernelSupported(EvalKernel::SSE) ? EvalKernel::SSE :
+                                   EvalKernel::SCALAR;
+    return best;
+}
+
+void evaluateBatch(const EvalPosition* positions, int* scores, size_t count) {
+    evaluateBatch(positions, scores, count, bestEvalKernel());
+}
+
+void evaluateBatch(const EvalPosition* positions, int* scores, size_t count, EvalKernel kernel) {
+    // Nieobsługiwana wersja przechodzi na skalarną
+    if (!isEvalKernelSupported(kernel)) {
+        kernel = EvalKernel::SCALAR;
+    }
+
+    switch (kernel) {
+#ifdef EVAL_X86
+        case EvalKernel::AVX2: evaluateBatchAvx2(positions, scores, count); break;
+        case EvalKernel::SSE: evaluateBatchSse(positions, scores, count); break;
+#endif
+        default: evaluateBatchScalar(positions, scores, count); break;
+    }
+}
+
+void PositionBuffer::reserve(size_t count) {
+    for (int s = 0; s < 2; s++) {
+        men[s].reserve(count);
+        kings[s].reserve(count);
+    }
+}
+
+void PositionBuffer::clear() {
+    for (int s = 0; s < 2; s++) {
+        men[s].clear();
+        kings[s].clear();
+    }
+}
+
+void PositionBuffer::push(const EvalPosition& position) {
+    for (int s = 0; s < 2; s++) {
+        men[s].push_back(position.men[s]);
+        kings[s].push_back(position.kings[s]);
+    }
+}
+
+EvalPosition PositionBuffer::at(size_t index) const {
+    EvalPosition position;
+    for (int s = 0; s < 2; s++) {
+        position.men[s] = men[s][index];
+        position.kings[s] = kings[s][index];
+    }
+    return position;
+}
+
+static void evaluateArrays(const MaskArrays& arrays, int* scores, size_t count, EvalKernel kernel) {
+    switch (kernel) {
+#ifdef EVAL_X86
+        case EvalKernel::AVX2: evaluateArraysAvx2(arrays, scores, count); break;
+        case EvalKernel::SSE: evaluateArraysSse(arrays, scores, count); break;
+#endif
+        default: evaluateArraysScalar(arrays, scores, count); break;
+    }
+}
+
+void evaluateBuffer(const PositionBuffer& buffer, int* scores, int threads) {
+    evaluateBuffer(buffer, scores, threads, bestEvalKernel());
+}
+
+void evaluateBuffer(const PositionBuffer& buffer, int* scores, int threads, EvalKernel kernel) {
+    if (!isEvalKernelSupported(kernel)) {
+        kernel = EvalKernel::SCALAR;
+    }
+
+    size_t count = buffer.size();
+    if (threads <= 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (count < PARALLEL_EVAL_THRESHOLD) {
+        threads = 1;
+    }
+
+    // Każdy wątek dostaje ciągły fragment o długości podzielnej przez 8,
+    // żeby tylko ostatni kończył się ogonem skalarnym
+    size_t chunk = (count + threads - 1) / threads;
+    chunk = (chunk + 7) & ~size_t(7);
+
+    std::vector<std::thread> workers;
+    for (size_t begin = chunk; begin < count; begin += chunk) {
+        MaskArrays arrays;
+        for (int s = 0; s < 2; s++) {
+            arrays.men[s] = buffer.menData(s == 1) + begin;
+            arrays.kings[s] = buffer.kingsData(s == 1) + begin;
+        }
+        size_t length = std::min(chunk, count - begin);
+        workers.emplace_back([arrays, scores, begin, length, kernel]() {
+            evaluateArrays(arrays, scores + begin, length, kernel);
+        });
+    }
+
+    // Pierwszy fragment liczy wątek wywołujący
+    MaskArrays arrays;
+    for (int s = 0; s < 2; s++) {
+        arrays.men[s] = buffer.menData(s == 1);
+        arrays.kings[s] = buffer.kingsData(s == 1);
+    }
+    evaluateArrays(arrays, scores, std::min(chunk, count), kernel);
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
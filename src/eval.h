@@ -0,0 +1,64 @@
+#ifndef EVAL_H
+#define EVAL_H
+
+#include <cstddef>
+#include <vector>
+#include "board.h"
+
+// Pozycja zapisana samymi maskami, indeksowanymi stroną jak w Board: [0] = gracz, [1] = AI
+struct EvalPosition {
+    Bitboard men[2];
+    Bitboard kings[2];
+
+    EvalPosition();
+    explicit EvalPosition(const Board& board);
+};
+
+// Wersje jądra oceny; domyślnie używana jest najszybsza obsługiwana przez procesor
+enum class EvalKernel {
+    SCALAR,
+    SSE,   // SSE4.1, 4 pozycje naraz
+    AVX2   // 8 pozycji naraz
+};
+
+// Ocena z tymi samymi składnikami i wynikiem co Board::evaluate, liczona na maskach:
+// awans i centrum jako liczba bitów w maskach bitów numeru wiersza i wagi kolumny,
+// możliwość bicia przez przesunięcia masek we wszystkich kierunkach
+int evaluatePosition(const EvalPosition& position);
+
+// Ocena wielu pozycji naraz (scores[i] dla positions[i])
+void evaluateBatch(const EvalPosition* positions, int* scores, size_t count);
+void evaluateBatch(const EvalPosition* positions, int* scores, size_t count, EvalKernel kernel);
+
+EvalKernel bestEvalKernel();
+bool isEvalKernelSupported(EvalKernel kernel);
+
+// Bufor pozycji w układzie struktury tablic: każda z czterech masek w osobnej,
+// ciągłej tablicy, więc jądro wektorowe czyta je zwykłymi ładowaniami bez transpozycji
+class PositionBuffer {
+public:
+    void reserve(size_t count);
+    void clear();
+    void push(const EvalPosition& position);
+    void push(const Board& board) { push(EvalPosition(board)); }
+
+    size_t size() const { return men[0].size(); }
+    EvalPosition at(size_t index) const;
+
+    const Bitboard* menData(bool forAI) const { return men[forAI ? 1 : 0].data(); }
+    const Bitboard* kingsData(bool forAI) const { return kings[forAI ? 1 : 0].data(); }
+
+private:
+    std::vector<Bitboard> men[2];
+    std::vector<Bitboard> kings[2];
+};
+
+// Od tylu pozycji ocena bufora jest dzielona między wątki
+const size_t PARALLEL_EVAL_THRESHOLD = 1 << 16;
+
+// Ocena wszystkich pozycji bufora (scores musi mieć miejsce na buffer.size() wyników).
+// threads = 0: tyle wątków, ile rdzeni procesora
+void evaluateBuffer(const PositionBuffer& buffer, int* scores, int threads = 0);
+void evaluateBuffer(const PositionBuffer& buffer, int* scores, int threads, EvalKernel kernel);
+
+#endif // EVAL_H
@@ -8,11 +8,15 @@ Game::Game() : turnAI(false) {
 void Game::run() {
     showDifficultyMenu();
 
+    // Nowa partia: wiedza AI z poprzedniej nie dotyczy tej planszy
+    board.init();
+    ai.newGame();
+    turnAI = false;
+
     while (!checkVictory()) {
         board.printBoard();
         processTurn();
         turnAI = !turnAI;
-        checkPromotion(board.cells);
     }
     std::cout << "Koniec gry!" << std::endl;
 }
@@ -36,18 +40,34 @@ void Game::showDifficultyMenu() {
 }
 
 void Game::processTurn() {
+    SearchLimits limits;
+    limits.maxDepth = static_cast<int>(difficulty);
+
     if (turnAI) {
-        // Dla AI wykorzystaj funkcję getBestMove
-        Move bestMove = ai.getBestMove(board, difficulty);
-        board.applyMove(bestMove);
+        // Po trafionym ponderingu przeszukiwanie już trwa, a często jest skończone
+        if (!search.active()) {
+            search.start(board, limits);
+        }
+        Move bestMove = search.get();
+        MoveUndo undo;
+        board.applyMove(bestMove, undo);
         std::cout << "AI wykonało ruch" << std::endl;
+        checkPromotion(bestMove, undo);
+
+        if (pondering) {
+            search.ponder(board, limits);
+        }
     } else {
         // Opcja użytkownika – pobranie ruchu z GUI lub konsoli
         // Na potrzeby demonstracji możemy pobrać dane wejściowe z konsoli
-        Move move;
+        int srcRow, srcCol, dstRow, dstCol;
         std::cout << "Podaj ruch (srcRow srcCol dstRow dstCol): ";
-        std::cin >> move.srcRow >> move.srcCol >> move.dstRow >> move.dstCol;
-        board.applyMove(move);
+        std::cin >> srcRow >> srcCol >> dstRow >> dstCol;
+        Move move(srcRow, srcCol, dstRow, dstCol);
+        MoveUndo undo;
+        board.applyMove(move, undo);
+        checkPromotion(move, undo);
+        search.playerMoved(board);
     }
 }
 
@@ -56,32 +76,24 @@ bool Game::checkVictory() {
     // np. brak ruchów lub pionków którejś ze stron
 
     // Sprawdź czy któraś strona nie ma pionków lub ruchów
-    if (!board.hasValidMoves(false) || board.countPieces(false) == 0) {
+    if (!legalMoves.hasMoves(board, false) || board.countPieces(false) == 0) {
         std::cout << "AI wygrało!" << std::endl;
         return true;
     }
-    if (!board.hasValidMoves(true) || board.countPieces(true) == 0) {
+    if (!legalMoves.hasMoves(board, true) || board.countPieces(true) == 0) {
         std::cout << "Gracz wygrał!" << std::endl;
         return true;
     }
     return false;
 }
 
-void Game::checkPromotion(std::shared_ptr<Piece> cells[Board::SIZE][Board::SIZE]) {
-    // Promocja gracza (wiersz 0)
-    for (int col = 0; col < 8; ++col) {
-        auto& piece = cells[0][col];
-        if (piece && !piece->getIsAI() && !piece->getIsKing()) {
-            piece->promote();
-            std::cout << "Gracz pionek awansował do damki na (0," << col << ")!" << std::endl;
-        }
-    }
-    // Promocja AI (wiersz 7)
-    for (int col = 0; col < 8; ++col) {
-        auto& piece = cells[7][col];
-        if (piece && piece->getIsAI() && !piece->getIsKing()) {
-            piece->promote();
-            std::cout << "AI pionek awansował do damki na (7," << col << ")!" << std::endl;
-        }
+void Game::checkPromotion(const Move& move, const MoveUndo& undo) {
+    // Promocję wykonuje Board::applyMove, tutaj tylko ją ogłaszamy
+    if (!undo.promoted) return;
+
+    if (undo.side == 0) {
+        std::cout << "Gracz pionek awansował do damki na (" << int(move.dstRow) << "," << int(move.dstCol) << ")!" << std::endl;
+    } else {
+        std::cout << "AI pionek awansował do damki na (" << int(move.dstRow) << "," << int(move.dstCol) << ")!" << std::endl;
     }
-}
\ No newline at end of file
+}
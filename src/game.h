@@ -11,14 +11,19 @@ public:
 
     // Główna pętla gry
     void run();
-    void checkPromotion(std::shared_ptr<Piece> cells[Board::SIZE][Board::SIZE]);
+    void checkPromotion(const Move& move, const MoveUndo& undo);
     void setDifficulty(Difficulty diff) { difficulty = diff; }
+    // Pondering: AI liczy odpowiedź na przewidywany ruch gracza, gdy ten wpisuje swój
+    void setPondering(bool enabled) { pondering = enabled; }
 
 private:
     Board board;
     AI ai;
+    AsyncSearch search{ai};
+    LegalMoveCache legalMoves; // ruchy bieżącej pozycji dla warunków końca gry
     bool turnAI; // true, gdy kolej AI, false dla gracza
     Difficulty difficulty = Difficulty::MEDIUM; // domyślnie średni
+    bool pondering = true;
 
     void processTurn();
     bool checkVictory();
@@ -3,11 +3,56 @@
 #include <sstream>
 #include <SDL_ttf.h>
 #include <string>
+#include <vector>
+
+// Warstwa sprite'a: koło o promieniu radius, a dla innerRadius >= 0 tylko
+// pierścień między innerRadius a radius. Kolejne warstwy przykrywają poprzednie.
+struct SpriteLayer {
+    int radius;
+    int innerRadius;
+    SDL_Color color;
+};
+
+// Tekstura size x size (size = 2 * radius + 1) z przezroczystym tłem, piksele
+// liczone na CPU tak samo jak przy rysowaniu punkt po punkcie
+static SDL_Texture* createDiscSprite(SDL_Renderer* renderer, int radius, const std::vector<SpriteLayer>& layers,
+                                     int& size) {
+    size = 2 * radius + 1;
+    std::vector<Uint32> pixels(size * size, 0); // RGBA8888, alfa 0
+
+    for (const auto& layer : layers) {
+        Uint32 color = (Uint32(layer.color.r) << 24) | (Uint32(layer.color.g) << 16) |
+                       (Uint32(layer.color.b) << 8) | layer.color.a;
+        for (int y = -radius; y <= radius; y++) {
+            for (int x = -radius; x <= radius; x++) {
+                int distSq = x*x + y*y;
+                if (distSq <= layer.radius * layer.radius &&
+                    (layer.innerRadius < 0 || distSq >= layer.innerRadius * layer.innerRadius)) {
+                    pixels[(y + radius) * size + (x + radius)] = color;
+                }
+            }
+        }
+    }
+
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+                                             SDL_TEXTUREACCESS_STATIC, size, size);
+    if (!texture) return nullptr;
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    if (SDL_UpdateTexture(texture, nullptr, pixels.data(), size * static_cast<int>(sizeof(Uint32))) != 0) {
+        SDL_DestroyTexture(texture);
+        return nullptr;
+    }
+    return texture;
+}
 
 GUI::GUI() : window(nullptr), renderer(nullptr), font(nullptr), gameRunning(true), 
              playerTurn(true), gameOver(false), selectedRow(-1), 
              selectedCol(-1), pieceSelected(false) {
     gameStatus = "Twoja kolej - wybierz pionek";
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        sprites[i] = nullptr;
+        spriteSizes[i] = 0;
+    }
 }
 
 GUI::~GUI() {
@@ -40,6 +85,12 @@ bool GUI::init() {
     }
     std::cout << "Renderer OK" << std::endl;
 
+    if (!createSprites()) {
+        std::cerr << "Nie można utworzyć tekstur pionków: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    std::cout << "Tekstury OK" << std::endl;
+
     if (TTF_Init() == -1) {
         std::cerr << "Nie można zainicjować SDL_ttf: " << TTF_GetError() << std::endl;
         return false;
@@ -64,8 +115,6 @@ void GUI::run(Board &board) {
             processAITurn(board);
         }
 
-        checkPromotion(board.cells);
-        
         render(board);
         checkGameEnd(board);
         SDL_Delay(16); // ~60 FPS
@@ -76,6 +125,7 @@ void GUI::handleEvents(Board &board) {
     SDL_Event e;
     while (SDL_PollEvent(&e)) {
         if (e.type == SDL_QUIT) {
+            aiSearch.cancel();
             gameRunning = false;
         }
         else if (e.type == SDL_MOUSEBUTTONDOWN) {
@@ -102,15 +152,24 @@ void GUI::handleEvents(Board &board) {
             }
         }
         else if (e.type == SDL_KEYDOWN) {
-            if (e.key.keysym.sym == SDLK_r && gameOver) {
-                // Restart gry
+            if (e.key.keysym.sym == SDLK_r) {
+                // Restart gry, także w trakcie ruchu AI
+                aiSearch.cancel();
                 board.init();
+                ai.newGame();
                 gameOver = false;
                 playerTurn = true;
                 resetSelection();
                 moveCount = 0;
                 gameStatus = "Nowa gra - Twoja kolej";
             }
+            else if (e.key.keysym.sym == SDLK_p) {
+                ponderingEnabled = !ponderingEnabled;
+                if (!ponderingEnabled && aiSearch.isPondering()) {
+                    aiSearch.cancel();
+                }
+                gameStatus = ponderingEnabled ? "Pondering włączony" : "Pondering wyłączony";
+            }
         }
     }
 }
@@ -163,47 +222,10 @@ void GUI::drawPieces(Board &board) {
         for (int col = 0; col < 8; col++) {
             auto piece = board.getPiece(row, col);
             if (piece) {
-                int centerX = BOARD_OFFSET_X + col * CELL_SIZE + CELL_SIZE / 2;
-                int centerY = BOARD_OFFSET_Y + row * CELL_SIZE + CELL_SIZE / 2;
-                int radius = CELL_SIZE / 3;
-                
-                // Rysuj pionek (okrąg)
                 if (piece->getIsAI()) {
-                    setColor(139, 69, 19); // Brązowy dla AI
+                    drawSprite(piece->getIsKing() ? SPRITE_AI_KING : SPRITE_AI_MAN, row, col);
                 } else {
-                    setColor(255, 255, 255); // Biały dla gracza
-                }
-                
-                // Prosty sposób rysowania okręgu
-                for (int y = -radius; y <= radius; y++) {
-                    for (int x = -radius; x <= radius; x++) {
-                        if (x*x + y*y <= radius*radius) {
-                            SDL_RenderDrawPoint(renderer, centerX + x, centerY + y);
-                        }
-                    }
-                }
-                
-                // Ramka pionka
-                setColor(0, 0, 0);
-                for (int y = -radius; y <= radius; y++) {
-                    for (int x = -radius; x <= radius; x++) {
-                        int distSq = x*x + y*y;
-                        if (distSq <= radius*radius && distSq >= (radius-2)*(radius-2)) {
-                            SDL_RenderDrawPoint(renderer, centerX + x, centerY + y);
-                        }
-                    }
-                }
-                
-                // Oznaczenie damki
-                if (piece->getIsKing()) {
-                    setColor(255, 215, 0); // Złoty dla damki
-                    for (int y = -radius/2; y <= radius/2; y++) {
-                        for (int x = -radius/2; x <= radius/2; x++) {
-                            if (x*x + y*y <= (radius/2)*(radius/2)) {
-                                SDL_RenderDrawPoint(renderer, centerX + x, centerY + y);
-                            }
-                        }
-                    }
+                    drawSprite(piece->getIsKing() ? SPRITE_PLAYER_KING : SPRITE_PLAYER_MAN, row, col);
                 }
             }
         }
@@ -231,52 +253,69 @@ void GUI::drawSelectedCell() {
 }
 
 void GUI::drawValidMoves() {
-    setColor(0, 0, 255); // Niebieski dla zwykłych ruchów
-    
     for (const auto& move : validMoves) {
-        // Rysuj pole docelowe
-        int centerX = BOARD_OFFSET_X + move.dstCol * CELL_SIZE + CELL_SIZE / 2;
-        int centerY = BOARD_OFFSET_Y + move.dstRow * CELL_SIZE + CELL_SIZE / 2;
-        int radius = CELL_SIZE / 6;
-        
-        // Jeśli to bicie, użyj czerwonego koloru
-        if (!move.capturedPositions.empty()) {
-            setColor(255, 0, 0); // Czerwony dla bić
-            radius = CELL_SIZE / 4; // Większy znacznik
-        }
-        
-        // Rysuj znacznik ruchu
-        for (int y = -radius; y <= radius; y++) {
-            for (int x = -radius; x <= radius; x++) {
-                if (x*x + y*y <= radius*radius) {
-                    SDL_RenderDrawPoint(renderer, centerX + x, centerY + y);
-                }
-            }
-        }
-        
+        // Pole docelowe: niebieski znacznik, a dla bicia większy czerwony
+        drawSprite(move.isCapture() ? SPRITE_CAPTURE : SPRITE_MOVE, move.dstRow, move.dstCol);
+
         // Dla bić - oznacz zbite pionki
-        if (!move.capturedPositions.empty()) {
-            setColor(255, 100, 100); // Jasny czerwony
-            for (const auto& capturedPos : move.capturedPositions) {
-                int capX = BOARD_OFFSET_X + capturedPos.second * CELL_SIZE + CELL_SIZE / 2;
-                int capY = BOARD_OFFSET_Y + capturedPos.first * CELL_SIZE + CELL_SIZE / 2;
-                int capRadius = CELL_SIZE / 8;
-                
-                for (int y = -capRadius; y <= capRadius; y++) {
-                    for (int x = -capRadius; x <= capRadius; x++) {
-                        if (x*x + y*y <= capRadius*capRadius) {
-                            SDL_RenderDrawPoint(renderer, capX + x, capY + y);
-                        }
-                    }
-                }
-            }
+        for (int i = 0; i < move.captureCount; i++) {
+            drawSprite(SPRITE_CAPTURED, move.capturedRow(i), move.capturedCol(i));
+        }
+    }
+}
+
+bool GUI::createSprites() {
+    int radius = CELL_SIZE / 3;
+    SDL_Color black = {0, 0, 0, 255};
+    SDL_Color white = {255, 255, 255, 255}; // gracz
+    SDL_Color brown = {139, 69, 19, 255};   // AI
+    SDL_Color gold = {255, 215, 0, 255};    // oznaczenie damki
+
+    // Pionek: koło w kolorze strony z czarną ramką, damka dodatkowo ze złotym środkiem
+    sprites[SPRITE_PLAYER_MAN] = createDiscSprite(renderer, radius,
+        {{radius, -1, white}, {radius, radius - 2, black}}, spriteSizes[SPRITE_PLAYER_MAN]);
+    sprites[SPRITE_PLAYER_KING] = createDiscSprite(renderer, radius,
+        {{radius, -1, white}, {radius, radius - 2, black}, {radius / 2, -1, gold}}, spriteSizes[SPRITE_PLAYER_KING]);
+    sprites[SPRITE_AI_MAN] = createDiscSprite(renderer, radius,
+        {{radius, -1, brown}, {radius, radius - 2, black}}, spriteSizes[SPRITE_AI_MAN]);
+    sprites[SPRITE_AI_KING] = createDiscSprite(renderer, radius,
+        {{radius, -1, brown}, {radius, radius - 2, black}, {radius / 2, -1, gold}}, spriteSizes[SPRITE_AI_KING]);
+
+    sprites[SPRITE_MOVE] = createDiscSprite(renderer, CELL_SIZE / 6,
+        {{CELL_SIZE / 6, -1, {0, 0, 255, 255}}}, spriteSizes[SPRITE_MOVE]);
+    sprites[SPRITE_CAPTURE] = createDiscSprite(renderer, CELL_SIZE / 4,
+        {{CELL_SIZE / 4, -1, {255, 0, 0, 255}}}, spriteSizes[SPRITE_CAPTURE]);
+    sprites[SPRITE_CAPTURED] = createDiscSprite(renderer, CELL_SIZE / 8,
+        {{CELL_SIZE / 8, -1, {255, 100, 100, 255}}}, spriteSizes[SPRITE_CAPTURED]);
+
+    for (auto sprite : sprites) {
+        if (!sprite) return false;
+    }
+    return true;
+}
+
+void GUI::destroySprites() {
+    for (auto& sprite : sprites) {
+        if (sprite) {
+            SDL_DestroyTexture(sprite);
+            sprite = nullptr;
         }
-        
-        // Przywróć kolor dla następnego ruchu
-        setColor(0, 0, 255);
     }
 }
 
+void GUI::drawSprite(Sprite sprite, int row, int col) {
+    int size = spriteSizes[sprite];
+
+    // Sprite ma nieparzysty bok, więc środek pola wypada na jego środkowym pikselu
+    SDL_Rect dstRect = {
+        BOARD_OFFSET_X + col * CELL_SIZE + CELL_SIZE / 2 - size / 2,
+        BOARD_OFFSET_Y + row * CELL_SIZE + CELL_SIZE / 2 - size / 2,
+        size,
+        size
+    };
+    SDL_RenderCopy(renderer, sprites[sprite], nullptr, &dstRect);
+}
+
 void GUI::drawUI(Board& board) {
     // Zwiększ rozmiar prostokąta statusu
     SDL_Rect statusRect = {BOARD_OFFSET_X + BOARD_SIZE + 20, BOARD_OFFSET_Y, 220, 180};
@@ -424,7 +463,7 @@ void GUI::selectPiece(Board &board, int row, int col) {
         
         // Znajdź dostępne ruchy dla wybranego pionka
         validMoves.clear();
-        auto allMoves = board.getValidMoves(false); // false = gracz
+        const auto& allMoves = legalMoves.get(board, false); // false = gracz
         
         for (const auto& move : allMoves) {
             if (move.srcRow == row && move.srcCol == col) {
@@ -457,7 +496,10 @@ void GUI::makeMove(Board &board, int row, int col) {
     }
     
     if (validMove) {
-        board.applyMove(selectedMove);
+        MoveUndo undo;
+        board.applyMove(selectedMove, undo);
+        checkPromotion(selectedMove, undo);
+        aiSearch.playerMoved(board); // przewidziany ruch: odpowiedź jest już liczona
         playerTurn = false;
         gameStatus = "Kolej AI...";
         resetSelection();
@@ -475,37 +517,58 @@ void GUI::makeMove(Board &board, int row, int col) {
 }
 
 void GUI::processAITurn(Board &board) {
-    if (!board.hasValidMoves(true)) {
-        gameOver = true;
-        gameStatus = "Wygrałeś! Naciśnij R dla nowej gry";
+    if (!aiSearch.active()) {
+        if (!legalMoves.hasMoves(board, true)) {
+            gameOver = true;
+            gameStatus = "Wygrałeś! Naciśnij R dla nowej gry";
+            return;
+        }
+        aiSearch.start(board, aiLimits());
+        return;
+    }
+
+    // Wynik jeszcze niegotowy - klatka jest rysowana dalej bez czekania
+    if (!aiSearch.ready()) {
         return;
     }
 
-    Move aiMove = ai.getBestMove(board, currentDifficulty); // użyj wybranej trudności
+    Move aiMove = aiSearch.get();
     
     if (aiMove.srcRow != -1) { // Sprawdź czy AI znalazło ruch
-        board.applyMove(aiMove);
+        MoveUndo undo;
+        board.applyMove(aiMove, undo);
+        checkPromotion(aiMove, undo);
         playerTurn = true;
         gameStatus = "Twoja kolej - wybierz pionek";
         moveCount++;
+
+        if (ponderingEnabled) {
+            aiSearch.ponder(board, aiLimits());
+        }
     } else {
         gameOver = true;
         gameStatus = "Wygrałeś! AI nie ma ruchów. Naciśnij R dla nowej gry";
     }
 }
 
+SearchLimits GUI::aiLimits() const {
+    SearchLimits limits;
+    limits.maxDepth = static_cast<int>(currentDifficulty); // użyj wybranej trudności
+    return limits;
+}
+
 void GUI::checkGameEnd(Board &board) {
     if (gameOver) return;
     
     // Sprawdź czy gracz ma dostępne ruchy
-    if (!board.hasValidMoves(false)) {
+    if (!legalMoves.hasMoves(board, false)) {
         gameOver = true;
         gameStatus = "Przegrałeś! Naciśnij R dla nowej gry";
         return;
     }
     
     // Sprawdź czy AI ma dostępne ruchy
-    if (!board.hasValidMoves(true)) {
+    if (!legalMoves.hasMoves(board, true)) {
         gameOver = true;
         gameStatus = "Wygrałeś! Naciśnij R dla nowej gry";
         return;
@@ -536,10 +599,14 @@ void GUI::setColor(int r, int g, int b, int a) {
 }
 
 void GUI::close() {
+    aiSearch.cancel();
+
     if (font) {
         TTF_CloseFont(font);
         font = nullptr;
     }
+
+    destroySprites(); // tekstury należą do renderera
     
     if (renderer) {
         SDL_DestroyRenderer(renderer);
@@ -584,22 +651,14 @@ Board& GUI::getBoardRef() {
     return dummyBoard;
 }
 
-void GUI::checkPromotion(std::shared_ptr<Piece> cells[Board::SIZE][Board::SIZE]) {
-    // Promocja gracza (wiersz 0)
-    for (int col = 0; col < 8; ++col) {
-        auto& piece = cells[0][col];
-        if (piece && !piece->getIsAI() && !piece->getIsKing()) {
-            piece->promote();
-            std::cout << "Gracz pionek awansował do damki na (0," << col << ")!" << std::endl;
-        }
-    }
-    // Promocja AI (wiersz 7)
-    for (int col = 0; col < 8; ++col) {
-        auto& piece = cells[7][col];
-        if (piece && piece->getIsAI() && !piece->getIsKing()) {
-            piece->promote();
-            std::cout << "AI pionek awansował do damki na (7," << col << ")!" << std::endl;
-        }
+void GUI::checkPromotion(const Move& move, const MoveUndo& undo) {
+    // Promocję wykonuje Board::applyMove, tutaj tylko ją ogłaszamy
+    if (!undo.promoted) return;
+
+    if (undo.side == 0) {
+        std::cout << "Gracz pionek awansował do damki na (" << int(move.dstRow) << "," << int(move.dstCol) << ")!" << std::endl;
+    } else {
+        std::cout << "AI pionek awansował do damki na (" << int(move.dstRow) << "," << int(move.dstCol) << ")!" << std::endl;
     }
 }
 
@@ -609,10 +668,17 @@ void GUI::handleDifficultyClick(int mouseX, int mouseY) {
         if (mouseX >= buttonRect.x && mouseX <= buttonRect.x + buttonRect.w &&
             mouseY >= buttonRect.y && mouseY <= buttonRect.y + buttonRect.h) {
             
+            Difficulty difficulty = Difficulty::EASY;
             switch(i) {
-                case 0: currentDifficulty = Difficulty::EASY; break;
-                case 1: currentDifficulty = Difficulty::MEDIUM; break;
-                case 2: currentDifficulty = Difficulty::HARD; break;
+                case 0: difficulty = Difficulty::EASY; break;
+                case 1: difficulty = Difficulty::MEDIUM; break;
+                case 2: difficulty = Difficulty::HARD; break;
+            }
+
+            // Trwające przeszukiwanie zaczyna się od nowa z nową głębokością
+            if (difficulty != currentDifficulty) {
+                aiSearch.cancel();
+                currentDifficulty = difficulty;
             }
             break;
         }
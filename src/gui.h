@@ -15,7 +15,7 @@ public:
     void run(Board &board);
     void close();
 
-    void checkPromotion(std::shared_ptr<Piece> cells[Board::SIZE][Board::SIZE]);
+    void checkPromotion(const Move& move, const MoveUndo& undo);
 
 private:
     SDL_Window* window;
@@ -23,7 +23,30 @@ private:
     TTF_Font* font;  // Dodane pole dla czcionki
     AI ai;
 
+    // Pionki i znaczniki ruchów rysowane raz w init (rozmiar z CELL_SIZE),
+    // a w każdej klatce tylko kopiowane na planszę
+    enum Sprite {
+        SPRITE_PLAYER_MAN,
+        SPRITE_PLAYER_KING,
+        SPRITE_AI_MAN,
+        SPRITE_AI_KING,
+        SPRITE_MOVE,     // pole docelowe zwykłego ruchu
+        SPRITE_CAPTURE,  // pole docelowe bicia
+        SPRITE_CAPTURED, // pionek zbity w podświetlonym biciu
+        SPRITE_COUNT
+    };
+    SDL_Texture* sprites[SPRITE_COUNT];
+    int spriteSizes[SPRITE_COUNT]; // bok kwadratowej tekstury w pikselach
+
     Difficulty currentDifficulty = Difficulty::MEDIUM;
+
+    // Ruch AI liczony w osobnym wątku; pętla klatek tylko sprawdza, czy wynik jest gotowy.
+    // Z ponderingiem AI liczy odpowiedź na przewidywany ruch gracza już w czasie jego tury.
+    AsyncSearch aiSearch{ai};
+    bool ponderingEnabled = true;
+
+    // Ruchy bieżącej pozycji, o które każda klatka pyta na nowo
+    LegalMoveCache legalMoves;
     
     bool gameRunning;
     bool playerTurn;
@@ -60,6 +83,7 @@ private:
     void selectPiece(Board &board, int row, int col);
     void makeMove(Board &board, int row, int col);
     void processAITurn(Board &board);
+    SearchLimits aiLimits() const; // głębokość z wybranej trudności
     void checkGameEnd(Board &board);
     void resetSelection();
     Board& getBoardRef(); // Funkcja pomocnicza
@@ -69,6 +93,10 @@ private:
 
     void drawText(const std::string& text, int x, int y, SDL_Color color);
 
+    bool createSprites();
+    void destroySprites();
+    void drawSprite(Sprite sprite, int row, int col); // wyśrodkowany na polu
+
     // Stałe dla przycisków
     static const int BUTTON_WIDTH = 80;
     static const int BUTTON_HEIGHT = 30;
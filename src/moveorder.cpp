@@ -0,0 +1,171 @@
+#include "moveorder.h"
+#include "tt.h"
+
+// Wagi poszczególnych grup; historia jest zawsze mniejsza od wagi zabójców
+static const int HASH_MOVE_SCORE = 1 << 30;
+static const int CAPTURE_SCORE = 1 << 28;
+static const int CAPTURE_COUNT_SCORE = 1 << 20;
+static const int KILLER_SCORE = 1 << 26;
+static const int HISTORY_LIMIT = 1 << 24;
+static const int HISTORY_AGING = 4; // dzielnik historii przy kolejnym przeszukiwaniu
+
+void MoveOrdering::clear() {
+    for (int ply = 0; ply < MAX_PLY; ply++) {
+        killers[ply][0] = killers[ply][1] = 0;
+    }
+    for (int from = 0; from < 32; from++) {
+        for (int to = 0; to < 32; to++) {
+            history[from][to] = 0;
+        }
+    }
+}
+
+void MoveOrdering::age() {
+    for (int ply = 0; ply < MAX_PLY; ply++) {
+        killers[ply][0] = killers[ply][1] = 0;
+    }
+    for (int from = 0; from < 32; from++) {
+        for (int to = 0; to < 32; to++) {
+            history[from][to] /= HISTORY_AGING;
+        }
+    }
+}
+
+void MoveOrdering::order(MoveList& moves, uint16_t hashMove, int ply) const {
+    int scores[MoveList::CAPACITY];
+    bool haveKillers = ply < MAX_PLY;
+
+    for (int i = 0; i < moves.size(); i++) {
+        const Move& move = moves[i];
+        uint16_t packed = TranspositionTable::packMove(move);
+
+        if (hashMove && packed == hashMove) {
+            scores[i] = HASH_MOVE_SCORE;
+        } else if (move.isCapture()) {
+            scores[i] = CAPTURE_SCORE + move.captureCount * CAPTURE_COUNT_SCORE;
+        } else if (haveKillers && packed == killers[ply][0]) {
+            scores[i] = KILLER_SCORE + 1;
+        } else if (haveKillers && packed == killers[ply][1]) {
+            scores[i] = KILLER_SCORE;
+        } else {
+            int from = squareIndex(move.srcRow, move.srcCol);
+            int to = squareIndex(move.dstRow, move.dstCol);
+            scores[i] = history[from][to];
+        }
+    }
+
+    // Sortowanie przez wstawianie - listy są krótkie, a równe ruchy zachowują kolejność generatora
+    for (int i = 1; i < moves.size(); i++) {
+        Move move = moves[i];
+        int score = scores[i];
+        int j = i - 1;
+        while (j >= 0 && scores[j] < score) {
+            moves[j + 1] = moves[j];
+            scores[j + 1] = scores[j];
+            j--;
+        }
+        moves[j + 1] = move;
+        scores[j + 1] = score;
+    }
+}
+
+void MoveOrdering::recordCutoff(const Move& move, int ply, int depth) {
+    // Bicia i tak są sprawdzane jako pierwsze
+    if (move.isCapture()) return;
+
+    uint16_t packed = TranspositionTable::packMove(move);
+    if (ply < MAX_PLY && killers[ply][0] != packed) {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = packed;
+    }
+
+    int from = squareIndex(move.srcRow, move.srcCol);
+    int to = squareIndex(move.dstRow, move.dstCol);
+    history[from][to] += depth * depth;
+
+    // Po przekroczeniu limitu zmniejsz całą historię, zachowując proporcje
+    if (history[from][to] >= HISTORY_LIMIT) {
+        for (int f = 0; f < 32; f++) {
+            for (int t = 0; t < 32; t++) {
+                history[f][t] /= 2;
+            }
+        }
+    }
+}
+
+MovePicker::MovePicker(const Board& board, bool forAI, const MoveOrdering& ordering, uint16_t hashMove, int ply)
+    : board(board), forAI(forAI), ordering(ordering), hashMove(hashMove), ply(ply),
+      captures(board.hasCaptures(forAI)), stage(HASH_MOVE), killerSlot(0), index(0), playedCount(0) {
+    // Bicia powstają razem w jednym przeszukiwaniu ścieżek, więc generujemy je od razu
+    if (captures) {
+        board.generateMoves(forAI, moves);
+        ordering.order(moves, hashMove, ply);
+        stage = CAPTURES;
+    }
+}
+
+bool MovePicker::next(Move& move) {
+    while (true) {
+        switch (stage) {
+            case CAPTURES:
+                if (index < moves.size()) {
+                    move = moves[index++];
+                    return true;
+                }
+                stage = DONE;
+                break;
+
+            case HASH_MOVE:
+                stage = KILLERS;
+                if (hashMove && tryQuietMove(hashMove, move)) {
+                    return true;
+                }
+                break;
+
+            case KILLERS:
+                if (killerSlot < 2) {
+                    uint16_t killer = ordering.getKiller(ply, killerSlot++);
+                    if (killer && !wasPlayed(killer) && tryQuietMove(killer, move)) {
+                        return true;
+                    }
+                    break;
+                }
+                board.generateMoves(forAI, moves);
+                ordering.order(moves, 0, ply);
+                index = 0;
+                stage = QUIET_MOVES;
+                break;
+
+            case QUIET_MOVES:
+                while (index < moves.size()) {
+                    const Move& candidate = moves[index++];
+                    if (!wasPlayed(TranspositionTable::packMove(candidate))) {
+                        move = candidate;
+                        return true;
+                    }
+                }
+                stage = DONE;
+                break;
+
+            case DONE:
+                return false;
+        }
+    }
+}
+
+bool MovePicker::tryQuietMove(uint16_t packed, Move& move) {
+    Move candidate = TranspositionTable::unpackMove(packed);
+    if (!board.isLegalQuietMove(candidate, forAI)) {
+        return false;
+    }
+    played[playedCount++] = packed;
+    move = candidate;
+    return true;
+}
+
+bool MovePicker::wasPlayed(uint16_t packed) const {
+    for (int i = 0; i < playedCount; i++) {
+        if (played[i] == packed) return true;
+    }
+    return false;
+}
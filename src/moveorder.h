@@ -0,0 +1,65 @@
+#ifndef MOVEORDER_H
+#define MOVEORDER_H
+
+#include <cstdint>
+#include "board.h"
+
+// Kolejność sprawdzania ruchów w przeszukiwaniu alfa-beta:
+// ruch z tablicy transpozycji, bicia według liczby zbitych pionków,
+// ruchy-zabójcy z tej samej głębokości, a na końcu pozostałe ruchy według historii odcięć.
+class MoveOrdering {
+public:
+    static const int MAX_PLY = 128;
+
+    MoveOrdering() { clear(); }
+
+    void clear();
+    // Między ruchami partii: zabójcy są przypisani do odległości od korzenia, który
+    // się przesunął, więc znikają; historia zostaje, ale z mniejszą wagą niż nowe odcięcia
+    void age();
+    void order(MoveList& moves, uint16_t hashMove, int ply) const;
+
+    // Ruch, który spowodował odcięcie beta, zapamiętujemy jako zabójcę i w historii
+    void recordCutoff(const Move& move, int ply, int depth);
+
+    uint16_t getKiller(int ply, int slot) const { return ply < MAX_PLY ? killers[ply][slot] : 0; }
+
+private:
+    uint16_t killers[MAX_PLY][2];
+    int history[32][32]; // [pole startowe][pole docelowe]
+};
+
+// Ruchy węzła wydawane etapami, tak żeby przy wczesnym odcięciu nie generować reszty.
+// Przy obowiązkowym biciu od razu powstają wszystkie bicia (ruch z tablicy jako pierwszy).
+// W przeciwnym razie najpierw ruch z tablicy i zabójcy, sprawdzeni tylko pod kątem
+// legalności, a pozostałe ciche ruchy są generowane dopiero po nich.
+class MovePicker {
+public:
+    MovePicker(const Board& board, bool forAI, const MoveOrdering& ordering, uint16_t hashMove, int ply);
+
+    // Kolejny ruch; false, gdy ruchy się skończyły
+    bool next(Move& move);
+    bool capturesForced() const { return captures; }
+
+private:
+    enum Stage { CAPTURES, HASH_MOVE, KILLERS, QUIET_MOVES, DONE };
+
+    const Board& board;
+    bool forAI;
+    const MoveOrdering& ordering;
+    uint16_t hashMove;
+    int ply;
+    bool captures;
+
+    Stage stage;
+    int killerSlot;
+    int index;
+    uint16_t played[3]; // ruch z tablicy i zabójcy już wydani przed generowaniem
+    int playedCount;
+    MoveList moves;
+
+    bool tryQuietMove(uint16_t packed, Move& move);
+    bool wasPlayed(uint16_t packed) const;
+};
+
+#endif // MOVEORDER_H
@@ -0,0 +1,92 @@
+#include "threadpool.h"
+
+ThreadPool::ThreadPool(int threadCount) {
+    int count = threadCount < 1 ? 1 : threadCount;
+    for (int i = 0; i < count; i++) {
+        queues.emplace_back(new WorkQueue());
+    }
+    for (int i = 0; i < count; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        shuttingDown = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::run(std::vector<Task>& tasks) {
+    if (tasks.empty()) return;
+
+    // Licznik ustawiamy przed kolejkowaniem: wątek, który jeszcze kończy
+    // poprzednią partię, może przejąć nowe zadanie od razu
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending = static_cast<int>(tasks.size());
+    }
+
+    // Zadania rozdzielamy po kolei, więc każdy wątek zaczyna od najwcześniejszych
+    for (size_t i = 0; i < tasks.size(); i++) {
+        WorkQueue& queue = *queues[i % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(tasks[i]));
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    batch++;
+    wake.notify_all();
+    finished.wait(lock, [this] { return pending == 0; });
+}
+
+bool ThreadPool::takeTask(int id, Task& task) {
+    // Najpierw własna kolejka, potem kradzież od sąsiadów
+    {
+        WorkQueue& own = *queues[id];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.front());
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+
+    for (size_t i = 1; i < queues.size(); i++) {
+        WorkQueue& victim = *queues[(id + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(int id) {
+    uint64_t seenBatch = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return shuttingDown || batch != seenBatch; });
+            if (shuttingDown) return;
+            seenBatch = batch;
+        }
+
+        Task task;
+        while (takeTask(id, task)) {
+            task(id);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pending == 0) {
+                finished.notify_all();
+            }
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstdint>
+
+// Pula wątków z kradzieżą zadań.
+// Zadania są rozdzielane po kolejkach wątków; wątek bierze zadania z początku
+// własnej kolejki, a gdy ta się opróżni, zabiera je z końca kolejek pozostałych.
+class ThreadPool {
+public:
+    // Zadanie dostaje numer wykonującego je wątku (0 .. size() - 1)
+    typedef std::function<void(int worker)> Task;
+
+    explicit ThreadPool(int threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return static_cast<int>(workers.size()); }
+
+    // Wykonuje wszystkie zadania i czeka na zakończenie ostatniego
+    void run(std::vector<Task>& tasks);
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+
+    std::mutex mutex;
+    std::condition_variable wake;     // nowa partia zadań albo zamknięcie puli
+    std::condition_variable finished; // wykonano ostatnie zadanie partii
+    uint64_t batch = 0;
+    int pending = 0;
+    bool shuttingDown = false;
+
+    void workerLoop(int id);
+    bool takeTask(int id, Task& task);
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,114 @@
+#include "tt.h"
+
+TranspositionTable::TranspositionTable(size_t megabytes) : bucketCount(0), mask(0), generation(0) {
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(size_t megabytes) {
+    // Liczba kubełków to największa potęga dwójki mieszcząca się w limicie
+    size_t count = 1;
+    size_t limit = megabytes * 1024 * 1024 / sizeof(Bucket);
+    while (count * 2 <= limit) {
+        count *= 2;
+    }
+
+    buckets.reset(new Bucket[count]);
+    bucketCount = count;
+    mask = count - 1;
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i < bucketCount; i++) {
+        buckets[i].depthPreferred.write(0, 0);
+        buckets[i].alwaysReplace.write(0, 0);
+    }
+    generation = 0;
+}
+
+void TranspositionTable::newSearch() {
+    generation = (generation + 1) & 0x3F;
+}
+
+bool TranspositionTable::Entry::read(uint64_t key, uint64_t& out) const {
+    uint64_t value = data.load(std::memory_order_relaxed);
+    uint64_t stored = check.load(std::memory_order_relaxed) ^ value;
+    out = value;
+    return value != 0 && stored == key;
+}
+
+void TranspositionTable::Entry::write(uint64_t key, uint64_t value) {
+    check.store(key ^ value, std::memory_order_relaxed);
+    data.store(value, std::memory_order_relaxed);
+}
+
+bool TranspositionTable::probe(uint64_t key, TTData& data) const {
+    const Bucket& bucket = buckets[key & mask];
+    uint64_t value;
+
+    if (bucket.depthPreferred.read(key, value) || bucket.alwaysReplace.read(key, value)) {
+        unpack(value, data);
+        return true;
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, int depth, int score, Bound bound, uint16_t move) {
+    Bucket& bucket = buckets[key & mask];
+    uint64_t data = pack(depth, score, bound, move, generation);
+
+    // Wpis preferujący głębokość: ta sama pozycja, wpis z poprzednich przeszukiwań
+    // albo co najmniej tak samo głęboki wynik
+    uint64_t preferred = bucket.depthPreferred.data.load(std::memory_order_relaxed);
+    uint64_t preferredKey = bucket.depthPreferred.check.load(std::memory_order_relaxed) ^ preferred;
+    if (!preferred || preferredKey == key ||
+        entryGeneration(preferred) != generation ||
+        depth >= entryDepth(preferred)) {
+        bucket.depthPreferred.write(key, data);
+        return;
+    }
+
+    bucket.alwaysReplace.write(key, data);
+}
+
+// Skrót maski zbitych pionków do wartości 1..31; ścieżki bicia o tych samych
+// końcach różnią się zbitymi pionkami, więc zwykle także skrótem
+static int captureTag(Bitboard capturedMask) {
+    if (!capturedMask) return 0;
+    return 1 + static_cast<int>((capturedMask * 0x9E3779B97F4A7C15ULL) >> 58) % 31;
+}
+
+uint16_t TranspositionTable::packMove(const Move& move) {
+    if (move.srcRow < 0) return 0;
+    int from = squareIndex(move.srcRow, move.srcCol);
+    int to = squareIndex(move.dstRow, move.dstCol);
+    return static_cast<uint16_t>(0x8000 | (captureTag(move.capturedMask) << 10) | (to << 5) | from);
+}
+
+Move TranspositionTable::unpackMove(uint16_t packed) {
+    // Bicia nie da się odtworzyć z samych pól - trzeba je wygenerować
+    if (!packed || (packed & 0x7C00)) return Move();
+    int from = packed & 0x1F;
+    int to = (packed >> 5) & 0x1F;
+    return Move(squareRow(from), squareCol(from), squareRow(to), squareCol(to));
+}
+
+bool TranspositionTable::sameMove(const Move& move, uint16_t packed) {
+    return packed != 0 && packMove(move) == packed;
+}
+
+uint64_t TranspositionTable::pack(int depth, int score, Bound bound, uint16_t move, uint8_t generation) {
+    // Bit granicy jest zawsze niezerowy, więc data == 0 oznacza pusty wpis
+    return static_cast<uint64_t>(static_cast<uint32_t>(score)) |
+           (static_cast<uint64_t>(move) << 32) |
+           (static_cast<uint64_t>(static_cast<uint8_t>(depth)) << 48) |
+           (static_cast<uint64_t>(bound) << 56) |
+           (static_cast<uint64_t>(generation & 0x3F) << 58);
+}
+
+void TranspositionTable::unpack(uint64_t data, TTData& out) {
+    out.score = static_cast<int32_t>(static_cast<uint32_t>(data));
+    out.move = static_cast<uint16_t>(data >> 32);
+    out.depth = entryDepth(data);
+    out.bound = static_cast<Bound>((data >> 56) & 0x3);
+}
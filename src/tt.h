@@ -0,0 +1,78 @@
+#ifndef TT_H
+#define TT_H
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "board.h"
+
+// Rodzaj wyniku zapisanego w tablicy
+enum class Bound : uint8_t {
+    NONE = 0,
+    EXACT = 1,  // dokładna wartość
+    LOWER = 2,  // wartość >= score (odcięcie beta)
+    UPPER = 3   // wartość <= score (żaden ruch nie poprawił alfy)
+};
+
+// Rozpakowany wpis tablicy transpozycji
+struct TTData {
+    int score;
+    int depth;
+    Bound bound;
+    uint16_t move; // najlepszy ruch, zob. TranspositionTable::packMove
+};
+
+// Tablica transpozycji indeksowana hashem Zobrista planszy.
+// Każdy kubełek ma dwa wpisy: pierwszy zastępowany tylko przez głębsze
+// (lub nieaktualne) wyniki, drugi zastępowany zawsze.
+// Tablica jest współdzielona przez wątki bez blokad: wpis trzyma klucz
+// zXORowany z danymi, więc rozerwany zapis z dwóch wątków nie przejdzie kontroli klucza.
+class TranspositionTable {
+public:
+    static const int DEFAULT_SIZE_MB = 16;
+
+    explicit TranspositionTable(size_t megabytes = DEFAULT_SIZE_MB);
+
+    void resize(size_t megabytes);
+    void clear();
+    void newSearch(); // zwiększa licznik generacji, stare wpisy stają się kandydatami do zastąpienia
+
+    bool probe(uint64_t key, TTData& data) const;
+    void store(uint64_t key, int depth, int score, Bound bound, uint16_t move);
+
+    size_t sizeInEntries() const { return bucketCount * 2; }
+
+    // Ruch zapisany jako pole startowe i docelowe (indeksy ciemnych pól) z bitem obecności
+    // oraz 5-bitowym skrótem maski zbitych pionków (0 dla ruchu bez bicia), który odróżnia
+    // różne ścieżki bicia o tych samych końcach
+    static uint16_t packMove(const Move& move);
+    static Move unpackMove(uint16_t packed); // tylko ruch bez bicia; pusty Move dla 0 i bić
+    static bool sameMove(const Move& move, uint16_t packed);
+
+private:
+    struct Entry {
+        std::atomic<uint64_t> check; // klucz ^ data
+        std::atomic<uint64_t> data;  // wynik (32 bity), ruch (16), głębokość (8), granica (2), generacja (6)
+
+        bool read(uint64_t key, uint64_t& out) const;
+        void write(uint64_t key, uint64_t value);
+    };
+
+    struct Bucket {
+        Entry depthPreferred;
+        Entry alwaysReplace;
+    };
+
+    std::unique_ptr<Bucket[]> buckets;
+    size_t bucketCount;
+    uint64_t mask;
+    uint8_t generation; // zmieniana tylko między przeszukiwaniami
+
+    static uint64_t pack(int depth, int score, Bound bound, uint16_t move, uint8_t generation);
+    static void unpack(uint64_t data, TTData& out);
+    static int entryDepth(uint64_t data) { return static_cast<int8_t>(data >> 48); }
+    static uint8_t entryGeneration(uint64_t data) { return static_cast<uint8_t>(data >> 58); }
+};
+
+#endif // TT_H